@@ -31,28 +31,73 @@ CONFIG-=app_bundle
 
 # add .cpp files
 SOURCES+= src/main.cpp \
+    src/AliasTable.cpp \
+    src/Alphabet.cpp \
+    src/ContextIndex.cpp \
+    src/Derivation.cpp \
+    src/Expression.cpp \
+    src/FrameStats.cpp \
+    src/Frustum.cpp \
+    src/HeadlessRenderer.cpp \
+    src/ImpostorAtlas.cpp \
+    src/InstanceBuffer.cpp \
+    src/Mesh.cpp \
     src/Plant.cpp \
     src/PlantBlueprint.cpp \
     src/MainWindow.cpp \
     src/PlantBlueprintDialog.cpp \
     src/SceneManagerDialog.cpp \
-    src/PlantScene.cpp
+    src/PlantScene.cpp \
+    src/RuleTable.cpp \
+    src/SceneRenderer.cpp \
+    src/ThreadPool.cpp \
+    src/TubeMesh.cpp \
+    src/TurtleTable.cpp
 
 # add .h files
 HEADERS+= \
+    include/AABB.h \
+    include/AliasTable.h \
+    include/Alphabet.h \
+    include/ContextIndex.h \
+    include/Derivation.h \
     include/Branch.h \
+    include/Expression.h \
+    include/FrameStats.h \
+    include/Frustum.h \
+    include/HeadlessRenderer.h \
+    include/Impostor.h \
+    include/ImpostorAtlas.h \
+    include/InstanceBuffer.h \
+    include/LeafInstance.h \
+    include/LODGeometry.h \
+    include/Mesh.h \
+    include/ModuleString.h \
     include/ProductionRule.h \
     include/Plant.h \
     include/PlantBlueprint.h \
+    include/PlantGeometry.h \
+    include/Philox.h \
+    include/PlantScratch.h \
+    include/Quaternion.h \
     include/MainWindow.h \
     include/PlantBlueprintDialog.h \
     include/SceneManagerDialog.h \
-    include/PlantScene.h
+    include/PlantScene.h \
+    include/RuleTable.h \
+    include/SceneRenderer.h \
+    include/ThreadPool.h \
+    include/TubeMesh.h \
+    include/TurtleTable.h
 
 # add the readme, glsl shader files and presets
 OTHER_FILES+= README.md \
 		shaders/BlinnPhong.fragment.glsl \
 		shaders/BlinnPhong.vertex.glsl \
+		shaders/Impostor.fragment.glsl \
+		shaders/Impostor.vertex.glsl \
+		shaders/Leaf.fragment.glsl \
+		shaders/Leaf.vertex.glsl \
     presets/*
 
 # add the ui forms
@@ -0,0 +1,101 @@
+#ifndef AABB_H_
+#define AABB_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <ngl/Vec3.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file AABB.h
+/// @brief This struct contains an axis aligned bounding box
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 19/05/17
+/// @struct AABB
+/// @brief Struct to contain an axis aligned bounding box in world space, used for frustum culling
+//----------------------------------------------------------------------------------------------------------------------
+typedef struct AABB
+{
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The minimum corner
+		//----------------------------------------------------------------------------------------------------------------------
+		ngl::Vec3 m_min;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The maximum corner
+		//----------------------------------------------------------------------------------------------------------------------
+		ngl::Vec3 m_max;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor. The box is initialised inside out so that it is empty until a point is added
+		//----------------------------------------------------------------------------------------------------------------------
+		AABB() :
+			m_min(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()),
+			m_max(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()){}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Check if nothing has been added to the box
+		/// @return True if the box is empty
+		//----------------------------------------------------------------------------------------------------------------------
+		bool isEmpty() const {return m_min.m_x > m_max.m_x;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Grow the box to contain a sphere
+		/// @param _point The centre of the sphere
+		/// @param _radius The radius of the sphere, used to account for branch thickness and leaf size
+		//----------------------------------------------------------------------------------------------------------------------
+		void extend(const ngl::Vec3& _point, float _radius = 0.0f)
+		{
+			m_min.m_x = std::min(m_min.m_x, _point.m_x - _radius);
+			m_min.m_y = std::min(m_min.m_y, _point.m_y - _radius);
+			m_min.m_z = std::min(m_min.m_z, _point.m_z - _radius);
+			m_max.m_x = std::max(m_max.m_x, _point.m_x + _radius);
+			m_max.m_y = std::max(m_max.m_y, _point.m_y + _radius);
+			m_max.m_z = std::max(m_max.m_z, _point.m_z + _radius);
+		}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Grow the box to contain spheres stored as separate coordinate arrays
+		/// Each axis is a separate linear pass over one array, so the loops can be vectorised
+		/// @param _x The x coordinates of the centres
+		/// @param _y The y coordinates of the centres
+		/// @param _z The z coordinates of the centres
+		/// @param _count The number of spheres
+		/// @param _radius The radius of every sphere
+		//----------------------------------------------------------------------------------------------------------------------
+		void extend(const float* _x, const float* _y, const float* _z, std::size_t _count, float _radius = 0.0f)
+		{
+			if (_count == 0) return;
+			extendAxis(_x, _count, _radius, m_min.m_x, m_max.m_x);
+			extendAxis(_y, _count, _radius, m_min.m_y, m_max.m_y);
+			extendAxis(_z, _count, _radius, m_min.m_z, m_max.m_z);
+		}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Grow the box to contain another box
+		/// @param _box The box to contain
+		//----------------------------------------------------------------------------------------------------------------------
+		void extend(const AABB& _box)
+		{
+			if (_box.isEmpty()) return;
+			extend(_box.m_min);
+			extend(_box.m_max);
+		}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Grow one axis of the box to contain a range of coordinates
+		/// @param _values The coordinates
+		/// @param _count The number of coordinates
+		/// @param _radius The radius added either side of each coordinate
+		/// @param _min The minimum of the axis
+		/// @param _max The maximum of the axis
+		//----------------------------------------------------------------------------------------------------------------------
+		static void extendAxis(const float* _values, std::size_t _count, float _radius, float& _min, float& _max)
+		{
+			float lowest = _values[0];
+			float highest = _values[0];
+			for (std::size_t i=1; i<_count; ++i)
+			{
+				lowest = std::min(lowest, _values[i]);
+				highest = std::max(highest, _values[i]);
+			}
+			_min = std::min(_min, lowest - _radius);
+			_max = std::max(_max, highest + _radius);
+		}
+} AABB;
+
+#endif // AABB_H_
@@ -0,0 +1,56 @@
+#ifndef ALIASTABLE_H_
+#define ALIASTABLE_H_
+
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file AliasTable.h
+/// @brief This class samples from a discrete distribution in constant time
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 23/05/17
+/// @class AliasTable
+/// @brief This class is Vose's alias method, used to choose between the successors of a stochastic rule
+/// Each of the n columns holds the probability of keeping the column and the column to use otherwise, so a sample is
+/// one column lookup and one comparison however many successors there are
+//----------------------------------------------------------------------------------------------------------------------
+class AliasTable
+{
+	public:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Build the table
+		/// @param _weights The weight of each outcome. These don't need to add up to 1, and if they are all 0 every
+		/// outcome is equally likely
+		//----------------------------------------------------------------------------------------------------------------------
+		void build(const std::vector<float>& _weights);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Choose an outcome
+		/// @param _column Random float in [0,1) choosing the column
+		/// @param _coin Random float in [0,1) choosing between the column and its alias
+		/// @return The index of the outcome
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned sample(float _column, float _coin) const
+		{
+			unsigned column = static_cast<unsigned>(_column * m_probabilities.size());
+			//Guard against rounding up to the size
+			if (column >= m_probabilities.size()) column = static_cast<unsigned>(m_probabilities.size()) - 1;
+			return _coin < m_probabilities[column] ? column : m_aliases[column];
+		}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for the number of outcomes
+		/// @return The number of outcomes
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned size() const {return static_cast<unsigned>(m_probabilities.size());}
+
+	private:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The probability of keeping each column
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<float> m_probabilities;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The outcome used when a column isn't kept
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<unsigned> m_aliases;
+};
+
+#endif // ALIASTABLE_H_
@@ -0,0 +1,146 @@
+#ifndef ALPHABET_H_
+#define ALPHABET_H_
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+#include "ModuleString.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file Alphabet.h
+/// @brief This class maps the characters of an L-system grammar to symbol ids
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 23/05/17
+/// @class Alphabet
+/// @brief This class assigns each character of a grammar an 8 bit symbol id and stores the arity of each symbol
+/// The turtle symbols have fixed ids, so plants interpret them without looking the characters up. Every other
+/// character is given the next free id the first time it is seen. The arity of a symbol is fixed by the first module
+/// written with it, e.g. A(t) or A, and every later module must have the same number of parameters
+//----------------------------------------------------------------------------------------------------------------------
+class Alphabet
+{
+	public:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief enum for the ids of the symbols the turtle interprets, in the order of the characters []F/\\+-&^
+		/// The brackets are first, so a bracket is any id <= POP. The rotations are named as in The Algorithmic Beauty of Plants
+		//----------------------------------------------------------------------------------------------------------------------
+		enum SYMBOL : uint8_t {PUSH = 0, POP = 1, DRAW = 2, ROLL_RIGHT = 3, ROLL_LEFT = 4, TURN_LEFT = 5, TURN_RIGHT = 6, PITCH_DOWN = 7, PITCH_UP = 8};
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @struct ModuleText
+		/// @brief Struct to contain a module as written in a grammar, before its arguments are compiled
+		//----------------------------------------------------------------------------------------------------------------------
+		typedef struct ModuleText
+		{
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The character of the symbol
+				//----------------------------------------------------------------------------------------------------------------------
+				char m_character;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The text of each argument between the brackets
+				//----------------------------------------------------------------------------------------------------------------------
+				std::vector<std::string> m_arguments;
+		} ModuleText;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor, which adds the turtle symbols
+		//----------------------------------------------------------------------------------------------------------------------
+		Alphabet();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Check if a symbol is a bracket
+		/// @param _symbol The symbol id
+		/// @return True if the symbol starts or ends a branch
+		//----------------------------------------------------------------------------------------------------------------------
+		static bool isBracket(uint8_t _symbol) {return _symbol <= POP;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get the id of a character, adding it if it hasn't been seen before
+		/// @param _character The character
+		/// @return The symbol id
+		//----------------------------------------------------------------------------------------------------------------------
+		uint8_t symbol(char _character);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get the character of a symbol
+		/// @param _symbol The symbol id
+		/// @return The character
+		//----------------------------------------------------------------------------------------------------------------------
+		char character(uint8_t _symbol) const {return m_characters[_symbol];}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get the number of parameters of a symbol
+		/// @param _symbol The symbol id
+		/// @return The number of parameters
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned arity(uint8_t _symbol) const {return m_arities[_symbol];}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Check a module has the arity of its symbol, fixing the arity if this is the first use of the symbol
+		/// @param _symbol The symbol id
+		/// @param _arity The number of parameters of the module
+		/// @return False if the symbol has a different arity
+		//----------------------------------------------------------------------------------------------------------------------
+		bool useArity(uint8_t _symbol, unsigned _arity);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Ignore a symbol when matching the context of context sensitive rules, e.g. the turtle rotations
+		/// @param _symbol The symbol id
+		//----------------------------------------------------------------------------------------------------------------------
+		void setIgnored(uint8_t _symbol) {m_isIgnored[_symbol] = true;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Check if a symbol is ignored when matching contexts
+		/// @param _symbol The symbol id
+		/// @return True if the symbol is ignored
+		//----------------------------------------------------------------------------------------------------------------------
+		bool isIgnored(uint8_t _symbol) const {return m_isIgnored[_symbol];}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for the number of symbols
+		/// @return The number of symbols
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned size() const {return static_cast<unsigned>(m_characters.size());}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Split a string into modules, e.g. "F(l*2,w)[+A(t)]" into F, [, +, A and ]
+		/// @param _string The string, without whitespace
+		/// @param _modules The modules
+		/// @return False if the brackets don't match or an argument is empty
+		//----------------------------------------------------------------------------------------------------------------------
+		static bool split(const std::string& _string, std::vector<ModuleText>& _modules);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Convert a string to modules, adding any new characters
+		/// The arguments must be constant expressions, as in an axiom
+		/// @param _string The string, without whitespace
+		/// @param _modules The modules
+		/// @return False if the string is invalid or uses a symbol with the wrong arity
+		//----------------------------------------------------------------------------------------------------------------------
+		bool encode(const std::string& _string, ModuleString& _modules);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Convert modules back to a string of characters, without their parameters
+		/// @param _modules The modules
+		/// @return The string
+		//----------------------------------------------------------------------------------------------------------------------
+		std::string decode(const ModuleString& _modules) const;
+
+	private:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Value of m_symbols for a character that hasn't been seen
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr unsigned s_unassigned = std::numeric_limits<unsigned>::max();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The symbol id of each character, or s_unassigned
+		//----------------------------------------------------------------------------------------------------------------------
+		std::array<unsigned, 256> m_symbols;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The character of each symbol id
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<char> m_characters;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of parameters of each symbol id
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<uint8_t> m_arities;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Whether the arity of each symbol id has been fixed by a module
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<bool> m_isArityKnown;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Whether each symbol id is ignored when matching contexts
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<bool> m_isIgnored;
+};
+
+#endif // ALPHABET_H_
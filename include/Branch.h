@@ -1,9 +1,8 @@
 #ifndef BRANCH_H_
 #define BRANCH_H_
 
-#include <string>
-#include <vector>
 #include <ngl/Vec3.h>
+#include "AABB.h"
 
 //----------------------------------------------------------------------------------------------------------------------
 /// @file Branch.h
@@ -16,32 +15,67 @@
 //----------------------------------------------------------------------------------------------------------------------
 typedef struct Branch
 {
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Id of the branch, unique within the plant
+		/// Branches are inserted in the middle of the container, so the index can't be used to key random numbers
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_id;
 		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Depth of tree when branch was created
 		//----------------------------------------------------------------------------------------------------------------------
 		unsigned m_creationDepth;
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief L-system string
+		/// @brief Index of the first module of the branch in the plant modules. The branch is the run of modules up to the next bracket
+		/// The plant refreshes this after every rewrite, so the modules are stored once and not copied into every branch
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_firstModule = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Number of modules in the branch
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_moduleCount = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Index of the parameters of the first module of the branch in the plant modules
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_firstParameter = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Index of the first node of the branch in the plant geometry
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_firstNode = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Number of nodes of the branch
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_nodeCount = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Radius of the branch, from the blueprint root radius and decay or the width of an F(l,w) module
+		//----------------------------------------------------------------------------------------------------------------------
+		float m_radius = 0.0f;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Bounding box of the branch and its leaves
+		//----------------------------------------------------------------------------------------------------------------------
+		AABB m_bounds;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The first index of the branch in the plant tube mesh
 		//----------------------------------------------------------------------------------------------------------------------
-		std::string m_string;
+		unsigned m_firstIndex = 0;
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief Positions of the branch nodes
+		/// @brief The number of indices of the branch in the plant tube mesh
 		//----------------------------------------------------------------------------------------------------------------------
-		std::vector<ngl::Vec3> m_nodePositions;
+		unsigned m_indexCount = 0;
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief Positions of the leaves
+		/// @brief The first leaf of the branch in the plant geometry
+		/// This is also its first instance in the most detailed leaf buffer, as both are added to in branch order
 		//----------------------------------------------------------------------------------------------------------------------
-		std::vector<ngl::Vec3> m_leafPositions;
+		unsigned m_firstLeaf = 0;
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief Orientations of the leaves
+		/// @brief The number of leaf instances of the branch
 		//----------------------------------------------------------------------------------------------------------------------
-		std::vector<ngl::Vec3> m_leafOrientations;
+		unsigned m_leafCount = 0;
 		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Constructor
 		//----------------------------------------------------------------------------------------------------------------------
-		Branch(unsigned _depth, std::string _string = "") :
-			m_creationDepth(_depth),
-			m_string(_string){}
+		Branch(unsigned _id, unsigned _depth) :
+			m_id(_id),
+			m_creationDepth(_depth){}
 } Branch;
 
 #endif // BRANCH_H_
@@ -0,0 +1,75 @@
+#ifndef CONTEXTINDEX_H_
+#define CONTEXTINDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "Alphabet.h"
+#include "ModuleString.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file ContextIndex.h
+/// @brief This class finds the neighbours of each module for context sensitive rules
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 23/05/17
+/// @class ContextIndex
+/// @brief This class stores the left and right neighbour of every module, skipping brackets and whole branches
+/// The left neighbour of a module is the module before it on the path from the root, so the first module of a branch
+/// sees the module the branch started from. The right neighbour is the next module in the same branch after any child
+/// branches, or none at the end of a branch. Both are found with a stack of brackets in one pass each way, so each
+/// context lookup during rewriting is a single array read. Modules the alphabet ignores are never neighbours
+//----------------------------------------------------------------------------------------------------------------------
+class ContextIndex
+{
+	public:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Index used for no neighbour
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr uint32_t s_none = std::numeric_limits<uint32_t>::max();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Index the modules, replacing the current index
+		/// @param _modules The modules
+		/// @param _alphabet The alphabet, for the arity of each symbol and the symbols to ignore
+		//----------------------------------------------------------------------------------------------------------------------
+		void build(const ModuleString& _modules, const Alphabet& _alphabet);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get the left neighbour of a module
+		/// @param _index The index of the module
+		/// @return The index of the neighbour, or s_none
+		//----------------------------------------------------------------------------------------------------------------------
+		uint32_t left(std::size_t _index) const {return m_left[_index];}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get the right neighbour of a module
+		/// @param _index The index of the module
+		/// @return The index of the neighbour, or s_none
+		//----------------------------------------------------------------------------------------------------------------------
+		uint32_t right(std::size_t _index) const {return m_right[_index];}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get the index of the first parameter of a module
+		/// @param _index The index of the module, or the number of modules for the total number of parameters
+		/// @return The index in the packed parameters
+		//----------------------------------------------------------------------------------------------------------------------
+		std::size_t firstParameter(std::size_t _index) const {return m_firstParameters[_index];}
+
+	private:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The left neighbour of each module
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<uint32_t> m_left;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The right neighbour of each module
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<uint32_t> m_right;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The index of the first parameter of each module, and the total number of parameters at the end
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<uint32_t> m_firstParameters;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The stack of neighbours at each open branch, kept to reuse its allocation
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<uint32_t> m_stack;
+};
+
+#endif // CONTEXTINDEX_H_
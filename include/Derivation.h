@@ -0,0 +1,149 @@
+#ifndef DERIVATION_H_
+#define DERIVATION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Alphabet.h"
+#include "ModuleString.h"
+#include "RuleTable.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file Derivation.h
+/// @brief This class derives an L-system string one module at a time without storing it
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 23/05/17
+/// @class Derivation
+/// @brief This class expands the axiom depth first, giving the modules of the derived string in order
+/// Each rewrite level holds only the successor currently being expanded, so the memory is proportional to the depth
+/// rather than to the length of the string, which grows exponentially. A module at the last level is returned, any
+/// other module is rewritten into the level below. The stochastic choices use the same rewrite number and module
+/// index as rewriting the whole string, so deriving the same number of rewrites gives the same modules. A plant
+/// repeats a rewrite that adds no F, so levelDepths finds how many rewrites reach a plant depth.
+/// Matching across the end of a successor needs the next one, so only grammars without contexts and with single
+/// module predecessors can be streamed
+//----------------------------------------------------------------------------------------------------------------------
+class Derivation
+{
+	public:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @struct Module
+		/// @brief Struct to contain a module of the derived string
+		//----------------------------------------------------------------------------------------------------------------------
+		typedef struct Module
+		{
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The symbol id
+				//----------------------------------------------------------------------------------------------------------------------
+				uint8_t m_symbol;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The parameters, which are valid until the next call to next
+				//----------------------------------------------------------------------------------------------------------------------
+				const float* m_parameters;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The number of the rewrite that created the module, or 0 if it is from the axiom
+				//----------------------------------------------------------------------------------------------------------------------
+				unsigned m_depth;
+		} Module;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor
+		/// @param _rules The compiled production rules
+		/// @param _alphabet The alphabet of the rules
+		/// @param _seed The plant seed for stochastic rules
+		//----------------------------------------------------------------------------------------------------------------------
+		Derivation(const RuleTable& _rules, const Alphabet& _alphabet, uint32_t _seed);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Check if a grammar can be derived one module at a time
+		/// @param _rules The compiled production rules
+		/// @return True if no rule has a context or a predecessor longer than one module
+		//----------------------------------------------------------------------------------------------------------------------
+		static bool canStream(const RuleTable& _rules);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Find the plant depth of each rewrite level, repeating a rewrite that adds no F as a plant does
+		/// Each rewrite is derived once to count its F, so this costs about as much as deriving the last level
+		/// @param _rules The compiled production rules
+		/// @param _alphabet The alphabet of the rules
+		/// @param _seed The plant seed for stochastic rules
+		/// @param _axiom The axiom
+		/// @param _depth The plant depth to reach
+		/// @return The plant depth of each level, starting with 0 for the axiom. The number of rewrites is one less than the size
+		//----------------------------------------------------------------------------------------------------------------------
+		static std::vector<unsigned> levelDepths(const RuleTable& _rules, const Alphabet& _alphabet, uint32_t _seed, const ModuleString& _axiom, unsigned _depth);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Start deriving
+		/// @param _axiom The axiom
+		/// @param _depth The number of rewrites
+		//----------------------------------------------------------------------------------------------------------------------
+		void start(const ModuleString& _axiom, unsigned _depth);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Derive the next module
+		/// @param _module Set to the next module
+		/// @return False if the whole string has been derived
+		//----------------------------------------------------------------------------------------------------------------------
+		bool next(Module& _module);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Check if a rule applied in the last rewrite
+		/// @return True if a rule matched a module of the level before the last, once those modules have been derived
+		//----------------------------------------------------------------------------------------------------------------------
+		bool isReplaced() const {return m_isReplaced;}
+
+	private:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @struct Frame
+		/// @brief Struct to contain the modules being expanded at one rewrite level
+		//----------------------------------------------------------------------------------------------------------------------
+		typedef struct Frame
+		{
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The modules, which are a successor or a module no rule matched
+				//----------------------------------------------------------------------------------------------------------------------
+				ModuleString m_modules;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The index of the next module to expand
+				//----------------------------------------------------------------------------------------------------------------------
+				std::size_t m_position;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The index of the first parameter of the next module
+				//----------------------------------------------------------------------------------------------------------------------
+				std::size_t m_parameter;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The number of the rewrite that created the modules
+				//----------------------------------------------------------------------------------------------------------------------
+				unsigned m_depth;
+		} Frame;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The compiled production rules
+		//----------------------------------------------------------------------------------------------------------------------
+		const RuleTable* m_rules;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The alphabet of the rules
+		//----------------------------------------------------------------------------------------------------------------------
+		const Alphabet* m_alphabet;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The plant seed
+		//----------------------------------------------------------------------------------------------------------------------
+		uint32_t m_seed;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The frame of each level. Level 0 is the axiom and the last level is the derived string
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<Frame> m_frames;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of modules of each level expanded so far, which is the index of the next one in that level's string
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<uint32_t> m_positions;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The level of the frame being expanded
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_level;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Flag for whether a rule has applied in the last rewrite so far
+		//----------------------------------------------------------------------------------------------------------------------
+		bool m_isReplaced;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Storage for the parameters of a context sensitive match, which match needs but streamed grammars don't use
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<float> m_contextParameters;
+};
+
+#endif // DERIVATION_H_
@@ -0,0 +1,172 @@
+#ifndef EXPRESSION_H_
+#define EXPRESSION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file Expression.h
+/// @brief This class is an arithmetic or logical expression of module parameters, compiled to bytecode
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 23/05/17
+/// @class Expression
+/// @brief This class compiles the conditions and successor parameters of parametric rules when the grammar is read
+/// The bytecode runs on a small fixed size stack, so evaluating an expression doesn't parse or allocate anything.
+/// Parameters are referred to by index and parts that only use constants are folded when compiling.
+/// Supported operators, from lowest to highest precedence, are || && == != < > <= >= + - * / and ^,
+/// with unary - and !. Logical operators treat 0 as false and return 0 or 1
+//----------------------------------------------------------------------------------------------------------------------
+class Expression
+{
+	public:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief enum for the bytecode instructions
+		//----------------------------------------------------------------------------------------------------------------------
+		enum OPCODE : uint8_t {CONSTANT = 0, PARAMETER = 1, ADD = 2, SUBTRACT = 3, MULTIPLY = 4, DIVIDE = 5, POWER = 6,
+													 LESS = 7, GREATER = 8, LESS_EQUAL = 9, GREATER_EQUAL = 10, EQUAL = 11, NOT_EQUAL = 12,
+													 AND = 13, OR = 14, NEGATE = 15, NOT = 16};
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor for an expression that is always 0
+		//----------------------------------------------------------------------------------------------------------------------
+		Expression();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Compile an expression, replacing the current bytecode
+		/// @param _source The expression, without whitespace
+		/// @param _parameterNames The names of the parameters, in the order they are passed to evaluate
+		/// @return False if the expression is invalid, in which case it is left as 0
+		//----------------------------------------------------------------------------------------------------------------------
+		bool compile(const std::string& _source, const std::vector<std::string>& _parameterNames);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Evaluate the expression
+		/// @param _parameters The values of the parameters
+		/// @return The result
+		//----------------------------------------------------------------------------------------------------------------------
+		float evaluate(const float* _parameters) const;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Check if the expression doesn't use any parameters
+		/// @return True if the expression is a constant
+		//----------------------------------------------------------------------------------------------------------------------
+		bool isConstant() const {return m_code.size() == 1 && m_code[0].m_opcode == CONSTANT;}
+
+	private:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @struct Instruction
+		/// @brief Struct to contain one bytecode instruction
+		//----------------------------------------------------------------------------------------------------------------------
+		typedef struct Instruction
+		{
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The operation
+				//----------------------------------------------------------------------------------------------------------------------
+				OPCODE m_opcode;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The value pushed by CONSTANT
+				//----------------------------------------------------------------------------------------------------------------------
+				float m_constant;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The index of the parameter pushed by PARAMETER
+				//----------------------------------------------------------------------------------------------------------------------
+				unsigned m_parameter;
+		} Instruction;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @struct Parser
+		/// @brief Struct to contain the state of the recursive descent parser while compiling
+		//----------------------------------------------------------------------------------------------------------------------
+		typedef struct Parser
+		{
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The expression being compiled
+				//----------------------------------------------------------------------------------------------------------------------
+				const std::string& m_source;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The names of the parameters
+				//----------------------------------------------------------------------------------------------------------------------
+				const std::vector<std::string>& m_parameterNames;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The position of the next character to read
+				//----------------------------------------------------------------------------------------------------------------------
+				std::size_t m_position;
+		} Parser;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The maximum depth of the evaluation stack
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr unsigned s_maxStackSize = 32;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The bytecode, in the order it is run
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<Instruction> m_code;
+
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Apply an operator
+		/// @param _opcode The operator
+		/// @param _a The left operand, or the only operand of a unary operator
+		/// @param _b The right operand
+		/// @return The result
+		//----------------------------------------------------------------------------------------------------------------------
+		static float apply(OPCODE _opcode, float _a, float _b);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Add an operator to the bytecode, folding it if its operands are constants
+		/// @param _opcode The operator
+		//----------------------------------------------------------------------------------------------------------------------
+		void emit(OPCODE _opcode);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Check for an operator at the current position, and read past it if found
+		/// @param _parser The parser state
+		/// @param _operator The operator to check for
+		/// @return True if the operator was found
+		//----------------------------------------------------------------------------------------------------------------------
+		static bool accept(Parser& _parser, const char* _operator);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Parse a || expression, the lowest precedence
+		/// @param _parser The parser state
+		/// @return False if the expression is invalid
+		//----------------------------------------------------------------------------------------------------------------------
+		bool parseOr(Parser& _parser);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Parse a && expression
+		/// @param _parser The parser state
+		/// @return False if the expression is invalid
+		//----------------------------------------------------------------------------------------------------------------------
+		bool parseAnd(Parser& _parser);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Parse a comparison
+		/// @param _parser The parser state
+		/// @return False if the expression is invalid
+		//----------------------------------------------------------------------------------------------------------------------
+		bool parseComparison(Parser& _parser);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Parse a sum or difference
+		/// @param _parser The parser state
+		/// @return False if the expression is invalid
+		//----------------------------------------------------------------------------------------------------------------------
+		bool parseSum(Parser& _parser);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Parse a product or quotient
+		/// @param _parser The parser state
+		/// @return False if the expression is invalid
+		//----------------------------------------------------------------------------------------------------------------------
+		bool parseProduct(Parser& _parser);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Parse a negation or logical not
+		/// @param _parser The parser state
+		/// @return False if the expression is invalid
+		//----------------------------------------------------------------------------------------------------------------------
+		bool parseUnary(Parser& _parser);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Parse a power, which is right associative
+		/// @param _parser The parser state
+		/// @return False if the expression is invalid
+		//----------------------------------------------------------------------------------------------------------------------
+		bool parsePower(Parser& _parser);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Parse a number, parameter name or bracketed expression
+		/// @param _parser The parser state
+		/// @return False if the expression is invalid
+		//----------------------------------------------------------------------------------------------------------------------
+		bool parsePrimary(Parser& _parser);
+};
+
+#endif // EXPRESSION_H_
@@ -0,0 +1,209 @@
+#ifndef FRAMESTATS_H_
+#define FRAMESTATS_H_
+
+#include <array>
+#include <chrono>
+#include <deque>
+#include <string>
+#include <ngl/Types.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file FrameStats.h
+/// @brief This class measures the CPU and GPU time of each phase of a frame and counts the work submitted
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 23/05/17
+/// @struct FrameRecord
+/// @brief Struct to contain the measurements of one frame. Times are in milliseconds
+//----------------------------------------------------------------------------------------------------------------------
+typedef struct FrameRecord
+{
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of phases in a frame, matching FrameStats::PHASE
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr unsigned s_phaseCount = 4;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The frame number
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_frame = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The CPU time of each phase
+		//----------------------------------------------------------------------------------------------------------------------
+		std::array<double, s_phaseCount> m_cpuTime {{0.0, 0.0, 0.0, 0.0}};
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The GPU time of each phase, measured with timer queries
+		//----------------------------------------------------------------------------------------------------------------------
+		std::array<double, s_phaseCount> m_gpuTime {{0.0, 0.0, 0.0, 0.0}};
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of draw calls
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_drawCalls = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of triangles submitted, including every instance
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned long long m_triangles = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of instances submitted. A draw without instancing counts as one instance
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned long long m_instances = 0;
+} FrameRecord;
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @class FrameStats
+/// @brief This class records a FrameRecord for every frame drawn between beginFrame and endFrame
+/// GPU times are read back a few frames later so the CPU never waits for the timer queries
+//----------------------------------------------------------------------------------------------------------------------
+class FrameStats
+{
+	public:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief enum for the phases of a frame
+		//----------------------------------------------------------------------------------------------------------------------
+		enum PHASE : unsigned {SETUP = 0, GROUND = 1, PLANTS = 2, IMPOSTORS = 3};
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor. This does not need a GL context, the queries are created in the first frame
+		//----------------------------------------------------------------------------------------------------------------------
+		FrameStats(){}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Destructor. This deletes the queries, so it must be called with a valid GL context
+		//----------------------------------------------------------------------------------------------------------------------
+		~FrameStats();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Delete copy constructor since this owns GL objects
+		//----------------------------------------------------------------------------------------------------------------------
+		FrameStats(const FrameStats&) = delete;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Delete copy assignment since this owns GL objects
+		//----------------------------------------------------------------------------------------------------------------------
+		FrameStats& operator=(const FrameStats&) = delete;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Start measuring a frame, collecting the results of earlier frames that are ready
+		//----------------------------------------------------------------------------------------------------------------------
+		void beginFrame();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Start timing a phase. Phases can't be nested
+		/// @param _phase The phase
+		//----------------------------------------------------------------------------------------------------------------------
+		void beginPhase(PHASE _phase);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Stop timing the current phase
+		//----------------------------------------------------------------------------------------------------------------------
+		void endPhase();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Finish measuring a frame
+		//----------------------------------------------------------------------------------------------------------------------
+		void endFrame();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Wait for the GPU and collect the results of every frame still in flight
+		//----------------------------------------------------------------------------------------------------------------------
+		void flush();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Count a draw call in the current frame. Called by the classes that issue draws
+		/// @param _triangles The number of triangles in each instance
+		/// @param _instances The number of instances
+		//----------------------------------------------------------------------------------------------------------------------
+		static void recordDraw(unsigned _triangles, unsigned _instances = 1);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Write the recorded frames to a CSV file
+		/// @param _fileName The file to write
+		/// @return False if the file could not be written
+		//----------------------------------------------------------------------------------------------------------------------
+		bool writeCSV(const std::string& _fileName) const;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Remove the recorded frames
+		//----------------------------------------------------------------------------------------------------------------------
+		void clear() {m_history.clear();}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for the most recent frame with GPU times
+		/// @return Reference to the record, which is empty until the first results are collected
+		//----------------------------------------------------------------------------------------------------------------------
+		const FrameRecord& latest() const {return m_latest;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for the recorded frames
+		/// @return Reference to the frames, oldest first
+		//----------------------------------------------------------------------------------------------------------------------
+		const std::deque<FrameRecord>& history() const {return m_history;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for the name of a phase
+		/// @param _phase The phase
+		/// @return The name, used in the overlay and the CSV header
+		//----------------------------------------------------------------------------------------------------------------------
+		static const char* phaseName(unsigned _phase);
+
+	private:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of frames whose queries can be in flight at once
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr unsigned s_bufferedFrames = 3;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The maximum number of frames kept for export, around ten minutes at 60 frames per second
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr std::size_t s_maxHistory = 36000;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of draw calls in the current frame
+		/// The counters are static so the drawing classes don't need a reference to the stats
+		//----------------------------------------------------------------------------------------------------------------------
+		static unsigned s_drawCalls;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of triangles in the current frame
+		//----------------------------------------------------------------------------------------------------------------------
+		static unsigned long long s_triangles;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of instances in the current frame
+		//----------------------------------------------------------------------------------------------------------------------
+		static unsigned long long s_instances;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Flag for whether the queries have been created
+		//----------------------------------------------------------------------------------------------------------------------
+		bool m_isInitialised = false;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The timer queries of each buffered frame, one per phase
+		//----------------------------------------------------------------------------------------------------------------------
+		std::array<std::array<GLuint, FrameRecord::s_phaseCount>, s_bufferedFrames> m_queries;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The records of the buffered frames, waiting for their GPU times
+		//----------------------------------------------------------------------------------------------------------------------
+		std::array<FrameRecord, s_bufferedFrames> m_pending;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Bit mask of the phases that were timed in each buffered frame
+		//----------------------------------------------------------------------------------------------------------------------
+		std::array<unsigned, s_bufferedFrames> m_timedPhases {{0, 0, 0}};
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Flags for whether each buffered frame is waiting to be collected
+		//----------------------------------------------------------------------------------------------------------------------
+		std::array<bool, s_bufferedFrames> m_isPending {{false, false, false}};
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of frames begun
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_frameCount = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The buffered frame being recorded
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_current = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The phase being timed
+		//----------------------------------------------------------------------------------------------------------------------
+		PHASE m_phase = SETUP;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The CPU time the current phase started
+		//----------------------------------------------------------------------------------------------------------------------
+		std::chrono::steady_clock::time_point m_phaseStart;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The most recent frame with GPU times
+		//----------------------------------------------------------------------------------------------------------------------
+		FrameRecord m_latest;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The collected frames, oldest first
+		//----------------------------------------------------------------------------------------------------------------------
+		std::deque<FrameRecord> m_history;
+
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Read the GPU times of a buffered frame and add it to the history
+		/// @param _slot The buffered frame
+		/// @param _wait Flag for whether to wait for the GPU if the results are not ready
+		/// @return False if the results were not ready
+		//----------------------------------------------------------------------------------------------------------------------
+		bool collect(unsigned _slot, bool _wait);
+};
+
+#endif // FRAMESTATS_H_
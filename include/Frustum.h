@@ -0,0 +1,46 @@
+#ifndef FRUSTUM_H_
+#define FRUSTUM_H_
+
+#include <array>
+#include <ngl/Mat4.h>
+#include <ngl/Vec4.h>
+#include "AABB.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file Frustum.h
+/// @brief This class tests bounding boxes against the camera frustum
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 19/05/17
+/// @class Frustum
+/// @brief This class extracts the six clipping planes from the view projection matrix
+/// Planes are found using the method from Gribb and Hartmann, "Fast Extraction of Viewing Frustum Planes from the
+/// World-View-Projection Matrix"
+//----------------------------------------------------------------------------------------------------------------------
+class Frustum
+{
+	public:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief enum for the result of a bounding box test
+		//----------------------------------------------------------------------------------------------------------------------
+		enum TEST : unsigned {OUTSIDE = 0, INTERSECT = 1, INSIDE = 2};
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor
+		/// @param _viewProjection The view matrix multiplied by the projection matrix
+		//----------------------------------------------------------------------------------------------------------------------
+		Frustum(const ngl::Mat4& _viewProjection);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Test a bounding box against the frustum
+		/// @param _box The box to test
+		/// @return OUTSIDE if no part of the box is visible, INSIDE if all of it is, otherwise INTERSECT
+		//----------------------------------------------------------------------------------------------------------------------
+		TEST test(const AABB& _box) const;
+
+	private:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The clipping planes, stored as (a, b, c, d) where ax + by + cz + d >= 0 is inside
+		//----------------------------------------------------------------------------------------------------------------------
+		std::array<ngl::Vec4, 6> m_planes;
+};
+
+#endif // FRUSTUM_H_
@@ -0,0 +1,123 @@
+#ifndef HEADLESSRENDERER_H_
+#define HEADLESSRENDERER_H_
+
+#include <string>
+#include <vector>
+#include <ngl/Vec3.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file HeadlessRenderer.h
+/// @brief This class renders the scene without a window, for batch renders and benchmarks
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 22/05/17
+/// @struct HeadlessOptions
+/// @brief Struct to contain the settings of a headless run, set from the command line
+//----------------------------------------------------------------------------------------------------------------------
+typedef struct HeadlessOptions
+{
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The names of the PlantBlueprint presets to grow. The plants cycle through these
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<std::string> m_presets = {"GenericTree"};
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of plants, laid out on a square grid
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_plantCount = 1;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The distance between neighbouring plants on the grid
+		//----------------------------------------------------------------------------------------------------------------------
+		float m_spacing = 2.0f;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The distance beyond which plants are drawn as impostors
+		//----------------------------------------------------------------------------------------------------------------------
+		float m_impostorDistance = 45.0f;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of times to update the simulation before rendering
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_depth = 3;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Flag for whether to derive the plants to m_depth when they are created, without storing the L-system strings
+		/// This lets plants much deeper than the strings would fit in memory be grown
+		//----------------------------------------------------------------------------------------------------------------------
+		bool m_streamDerivation = false;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of frames to render
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_frames = 1;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The width of the images
+		//----------------------------------------------------------------------------------------------------------------------
+		int m_width = 1280;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The height of the images
+		//----------------------------------------------------------------------------------------------------------------------
+		int m_height = 720;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The directory to write the images and timings to
+		//----------------------------------------------------------------------------------------------------------------------
+		std::string m_outputDirectory = "render";
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Flag for whether to write the images. Benchmarks only need the timings
+		//----------------------------------------------------------------------------------------------------------------------
+		bool m_writeImages = true;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief A file of camera keys, one "eyeX eyeY eyeZ lookX lookY lookZ" per line
+		/// If this is empty the camera orbits the plants
+		//----------------------------------------------------------------------------------------------------------------------
+		std::string m_cameraFile;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The seed for the random number generator, so runs can be repeated
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_seed = 0;
+} HeadlessOptions;
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @class HeadlessRenderer
+/// @brief This class creates an offscreen GL context and framebuffer, grows the plants and renders the frames
+/// Each frame is written as a PNG and the timings are written to timings.csv in the output directory.
+/// The per phase CPU and GPU times and draw counts of each frame are written to stats.csv
+//----------------------------------------------------------------------------------------------------------------------
+class HeadlessRenderer
+{
+	public:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor
+		/// @param _options The settings of the run
+		//----------------------------------------------------------------------------------------------------------------------
+		HeadlessRenderer(const HeadlessOptions& _options) : m_options(_options){}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Perform the run. This needs a QGuiApplication to exist
+		/// @return 0 on success, otherwise 1
+		//----------------------------------------------------------------------------------------------------------------------
+		int run();
+
+	private:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The settings of the run
+		//----------------------------------------------------------------------------------------------------------------------
+		HeadlessOptions m_options;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The camera eye positions of each key
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<ngl::Vec3> m_eyes;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The camera look positions of each key
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<ngl::Vec3> m_looks;
+
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Read the camera keys from the camera file, or create an orbit around the plants
+		/// @return False if the camera file could not be read
+		//----------------------------------------------------------------------------------------------------------------------
+		bool createCameraPath();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Calculate the camera of a frame by interpolating between the keys
+		/// @param _frame The frame number
+		/// @param _eye The calculated eye position
+		/// @param _look The calculated look position
+		//----------------------------------------------------------------------------------------------------------------------
+		void cameraAtFrame(unsigned _frame, ngl::Vec3& _eye, ngl::Vec3& _look) const;
+};
+
+#endif // HEADLESSRENDERER_H_
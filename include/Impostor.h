@@ -0,0 +1,58 @@
+#ifndef IMPOSTOR_H_
+#define IMPOSTOR_H_
+
+#include <ngl/Vec3.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file Impostor.h
+/// @brief This file contains the data used to draw a plant as an impostor
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 21/05/17
+/// @struct ImpostorHandle
+/// @brief Struct to contain where the impostor of a plant is in the ImpostorAtlas, and whether it needs capturing again
+//----------------------------------------------------------------------------------------------------------------------
+typedef struct ImpostorHandle
+{
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The atlas layer containing the captured views, or -1 if the plant has never been captured
+		//----------------------------------------------------------------------------------------------------------------------
+		int m_layer = -1;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The atlas generation the layer belongs to. The layers are lost when the atlas grows
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_generation = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Flag for whether the plant has changed since it was captured
+		//----------------------------------------------------------------------------------------------------------------------
+		bool m_isOutdated = true;
+} ImpostorHandle;
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @struct ImpostorInstance
+/// @brief Struct to contain the per-instance attributes of one impostor. The layout matches shaders/Impostor.vertex.glsl
+//----------------------------------------------------------------------------------------------------------------------
+typedef struct ImpostorInstance
+{
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The centre of the plant bounding box, at attribute location 3
+		//----------------------------------------------------------------------------------------------------------------------
+		ngl::Vec3 m_centre;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The radius of the sphere around the bounding box, at attribute location 4
+		//----------------------------------------------------------------------------------------------------------------------
+		float m_radius;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The atlas layer, at attribute location 5. This is a float as integer attributes need glVertexAttribIPointer
+		//----------------------------------------------------------------------------------------------------------------------
+		float m_layer;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor
+		//----------------------------------------------------------------------------------------------------------------------
+		ImpostorInstance(const ngl::Vec3& _centre, float _radius, float _layer) :
+			m_centre(_centre),
+			m_radius(_radius),
+			m_layer(_layer){}
+} ImpostorInstance;
+
+#endif // IMPOSTOR_H_
@@ -0,0 +1,172 @@
+#ifndef IMPOSTORATLAS_H_
+#define IMPOSTORATLAS_H_
+
+#include <string>
+#include <vector>
+#include <ngl/Mat4.h>
+#include <ngl/Types.h>
+#include <ngl/Vec3.h>
+#include "Impostor.h"
+#include "InstanceBuffer.h"
+#include "Plant.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file ImpostorAtlas.h
+/// @brief This class captures distant plants into textures and draws them as camera facing quads
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 21/05/17
+/// @class ImpostorAtlas
+/// @brief This class owns a texture array with one layer per captured plant
+/// Each layer is a grid of views of the plant taken from evenly spaced angles around the y axis.
+/// All the impostors in a frame are drawn with one instanced draw call
+//----------------------------------------------------------------------------------------------------------------------
+class ImpostorAtlas
+{
+	public:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor. This creates GL objects, so it must be called with a valid GL context
+		//----------------------------------------------------------------------------------------------------------------------
+		ImpostorAtlas();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Destructor. This deletes the GL objects, so it must be called with a valid GL context
+		//----------------------------------------------------------------------------------------------------------------------
+		~ImpostorAtlas();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Delete copy constructor since this owns GL objects
+		//----------------------------------------------------------------------------------------------------------------------
+		ImpostorAtlas(const ImpostorAtlas&) = delete;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Delete copy assignment since this owns GL objects
+		//----------------------------------------------------------------------------------------------------------------------
+		ImpostorAtlas& operator=(const ImpostorAtlas&) = delete;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Check if a plant has an up to date capture in the atlas
+		/// @param _handle The impostor handle of the plant
+		/// @return True if the impostor can be drawn
+		//----------------------------------------------------------------------------------------------------------------------
+		bool isCurrent(const ImpostorHandle& _handle) const;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Render the views of a plant into its atlas layer
+		/// This leaves the framebuffer, viewport and clear colour as they were
+		/// @param _plant The plant to capture
+		/// @param _defaultFramebuffer The framebuffer to rebind afterwards, as QOpenGLWidget does not draw to framebuffer 0
+		//----------------------------------------------------------------------------------------------------------------------
+		void capture(Plant& _plant, GLuint _defaultFramebuffer);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Return the layer of a plant to the atlas
+		/// @param _handle The impostor handle of the plant
+		//----------------------------------------------------------------------------------------------------------------------
+		void release(ImpostorHandle& _handle);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Remove the impostors queued in the last frame
+		//----------------------------------------------------------------------------------------------------------------------
+		void clear() {m_instances.clear();}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Queue a captured plant to be drawn as an impostor
+		/// @param _plant The plant to draw
+		//----------------------------------------------------------------------------------------------------------------------
+		void add(const Plant& _plant);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Draw all the queued impostors with one draw call
+		/// @param _viewMatrix The view matrix from the camera
+		/// @param _projectionMatrix The projection matrix from the camera
+		/// @param _eye The camera position, used to face the quads and choose the views
+		//----------------------------------------------------------------------------------------------------------------------
+		void draw(const ngl::Mat4& _viewMatrix, const ngl::Mat4& _projectionMatrix, const ngl::Vec3& _eye);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for the shader name
+		/// @return Reference to the shader name
+		//----------------------------------------------------------------------------------------------------------------------
+		static const std::string& shaderName(){return s_shaderProgramName;}
+
+	private:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Handle for the shader name
+		//----------------------------------------------------------------------------------------------------------------------
+		static const std::string s_shaderProgramName;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of views captured around each plant
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr int s_viewCount = 8;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of columns of views in each layer
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr int s_columns = 4;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of rows of views in each layer
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr int s_rows = 2;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The width and height in pixels of each view
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr int s_viewSize = 128;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The level of detail the plants are captured at
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr unsigned s_captureLOD = 1;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The texture array
+		//----------------------------------------------------------------------------------------------------------------------
+		GLuint m_texture = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The framebuffer used to capture the views
+		//----------------------------------------------------------------------------------------------------------------------
+		GLuint m_framebuffer = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The depth buffer used to capture the views
+		//----------------------------------------------------------------------------------------------------------------------
+		GLuint m_depthBuffer = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of layers in the texture array
+		//----------------------------------------------------------------------------------------------------------------------
+		int m_capacity = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of layers that have been handed out
+		//----------------------------------------------------------------------------------------------------------------------
+		int m_layerCount = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Layers returned by deleted plants, which are reused before new layers
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<int> m_freeLayers;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Incremented whenever the texture is reallocated, which invalidates every layer
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_generation = 1;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The impostors to draw this frame
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<ImpostorInstance> m_instances;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Instance buffer to draw all the impostors with one draw call
+		//----------------------------------------------------------------------------------------------------------------------
+		InstanceBuffer m_instanceBuffer;
+
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Allocate the texture array storage
+		/// @param _layers The number of layers
+		//----------------------------------------------------------------------------------------------------------------------
+		void allocate(int _layers);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Give a plant a layer, growing the texture array if it is full
+		/// @param _handle The impostor handle of the plant
+		//----------------------------------------------------------------------------------------------------------------------
+		void assignLayer(ImpostorHandle& _handle);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Calculate a view matrix looking from a point to another point
+		/// @param _eye The camera position
+		/// @param _target The position to look at
+		/// @return The view matrix
+		//----------------------------------------------------------------------------------------------------------------------
+		static ngl::Mat4 lookAt(const ngl::Vec3& _eye, const ngl::Vec3& _target);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Calculate a square orthographic projection matrix
+		/// @param _halfSize Half the width and height of the view volume
+		/// @param _near The distance to the near plane
+		/// @param _far The distance to the far plane
+		/// @return The projection matrix
+		//----------------------------------------------------------------------------------------------------------------------
+		static ngl::Mat4 orthographic(float _halfSize, float _near, float _far);
+};
+
+#endif // IMPOSTORATLAS_H_
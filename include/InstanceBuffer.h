@@ -0,0 +1,126 @@
+#ifndef INSTANCEBUFFER_H_
+#define INSTANCEBUFFER_H_
+
+#include <cstddef>
+#include <vector>
+#include <ngl/Types.h>
+#include "Mesh.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file InstanceBuffer.h
+/// @brief This class draws many copies of one Mesh with a single instanced draw call
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 16/05/17
+/// @struct InstanceAttribute
+/// @brief Struct to describe one per-instance vertex attribute
+//----------------------------------------------------------------------------------------------------------------------
+typedef struct InstanceAttribute
+{
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The attribute location in the shader
+		//----------------------------------------------------------------------------------------------------------------------
+		GLuint m_location;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of floats in the attribute
+		//----------------------------------------------------------------------------------------------------------------------
+		GLint m_size;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The offset in bytes from the start of one instance
+		//----------------------------------------------------------------------------------------------------------------------
+		std::size_t m_offset;
+} InstanceAttribute;
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @class InstanceBuffer
+/// @brief This class owns a vertex array which combines a shared Mesh with a buffer of per-instance data
+/// The GL objects are created on the first upload, so this can be constructed without a GL context
+//----------------------------------------------------------------------------------------------------------------------
+class InstanceBuffer
+{
+	public:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor
+		/// @param _layout The per-instance attributes
+		/// @param _stride The size in bytes of one instance
+		//----------------------------------------------------------------------------------------------------------------------
+		InstanceBuffer(const std::vector<InstanceAttribute>& _layout, GLsizei _stride);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Destructor. This deletes the GL objects, so it must be called with a valid GL context
+		//----------------------------------------------------------------------------------------------------------------------
+		~InstanceBuffer();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Delete copy constructor since this owns GL objects
+		//----------------------------------------------------------------------------------------------------------------------
+		InstanceBuffer(const InstanceBuffer&) = delete;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Delete copy assignment since this owns GL objects
+		//----------------------------------------------------------------------------------------------------------------------
+		InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Move constructor. The GL objects are transferred to this object
+		/// @param _other The buffer to move from
+		//----------------------------------------------------------------------------------------------------------------------
+		InstanceBuffer(InstanceBuffer&& _other);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Move assignment. The GL objects are transferred to this object
+		/// @param _other The buffer to move from
+		//----------------------------------------------------------------------------------------------------------------------
+		InstanceBuffer& operator=(InstanceBuffer&& _other);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Upload the instance data to the GPU
+		/// The buffer only grows, so repeated uploads of a similar size do not reallocate
+		/// @param _mesh The mesh to draw instances of. This is only read on the first upload
+		/// @param _data Pointer to the first instance
+		/// @param _count The number of instances
+		//----------------------------------------------------------------------------------------------------------------------
+		void upload(const Mesh& _mesh, const void* _data, unsigned _count);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Draw all the instances with one draw call
+		//----------------------------------------------------------------------------------------------------------------------
+		void draw() const;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Draw a contiguous range of the instances with one draw call
+		/// GL 3.3 has no base instance, so the instance attributes are offset to the first instance instead
+		/// @param _first The first instance to draw
+		/// @param _count The number of instances to draw
+		//----------------------------------------------------------------------------------------------------------------------
+		void drawRange(unsigned _first, unsigned _count) const;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for m_count
+		/// @return The number of instances uploaded
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned instanceCount() const {return m_count;}
+
+	private:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The per-instance attributes
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<InstanceAttribute> m_layout;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The size in bytes of one instance
+		//----------------------------------------------------------------------------------------------------------------------
+		GLsizei m_stride;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Vertex array combining the mesh and the instance buffer
+		//----------------------------------------------------------------------------------------------------------------------
+		GLuint m_vao = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Buffer of per-instance data
+		//----------------------------------------------------------------------------------------------------------------------
+		GLuint m_vbo = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The allocated size of the instance buffer in bytes
+		//----------------------------------------------------------------------------------------------------------------------
+		std::size_t m_capacity = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of indices in the mesh
+		//----------------------------------------------------------------------------------------------------------------------
+		GLsizei m_indexCount = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of instances to draw
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_count = 0;
+};
+
+#endif // INSTANCEBUFFER_H_
@@ -0,0 +1,74 @@
+#ifndef LODGEOMETRY_H_
+#define LODGEOMETRY_H_
+
+#include <cstddef>
+#include <vector>
+#include "InstanceBuffer.h"
+#include "LeafInstance.h"
+#include "TubeMesh.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file LODGeometry.h
+/// @brief This file contains the settings and baked geometry of one plant level of detail
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 20/05/17
+/// @struct LODSettings
+/// @brief Struct to contain how much detail is kept at one level of detail
+//----------------------------------------------------------------------------------------------------------------------
+typedef struct LODSettings
+{
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of vertices around each branch
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_radialSegments;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Keep every nth branch node. The first and last nodes are always kept, so 0 keeps only those
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_nodeStride;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Keep every nth leaf, scaled up to cover the same area. 0 replaces the leaves of a branch with one card
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_leafStride;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The distance from the camera beyond which the next level of detail is used
+		//----------------------------------------------------------------------------------------------------------------------
+		float m_maxDistance;
+} LODSettings;
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @struct LODGeometry
+/// @brief Struct to contain the branch mesh and leaf instances of a plant at one level of detail
+//----------------------------------------------------------------------------------------------------------------------
+typedef struct LODGeometry
+{
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Continuous mesh of all the branches
+		//----------------------------------------------------------------------------------------------------------------------
+		TubeMesh m_tubeMesh;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Per-instance attributes of the leaves
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<LeafInstance> m_leafInstances;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Instance buffer to draw all the leaves with one draw call
+		//----------------------------------------------------------------------------------------------------------------------
+		InstanceBuffer m_leafBuffer;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Flag for whether the geometry matches the current branches
+		//----------------------------------------------------------------------------------------------------------------------
+		bool m_isBuilt = false;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Flag for whether the geometry has changed since it was last uploaded
+		//----------------------------------------------------------------------------------------------------------------------
+		bool m_isOutdated = true;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor
+		/// @param _radialSegments The number of vertices around each branch
+		//----------------------------------------------------------------------------------------------------------------------
+		LODGeometry(unsigned _radialSegments) :
+			m_tubeMesh(_radialSegments),
+			m_leafBuffer({{3, 3, offsetof(LeafInstance, m_position)}, {4, 4, offsetof(LeafInstance, m_orientation)}, {5, 1, offsetof(LeafInstance, m_scale)}}, sizeof(LeafInstance)){}
+} LODGeometry;
+
+#endif // LODGEOMETRY_H_
@@ -0,0 +1,39 @@
+#ifndef LEAFINSTANCE_H_
+#define LEAFINSTANCE_H_
+
+#include <ngl/Vec3.h>
+#include "Quaternion.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file LeafInstance.h
+/// @brief This struct contains the per-instance attributes of one leaf
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 17/05/17
+/// @struct LeafInstance
+/// @brief Struct to contain the per-instance attributes of one leaf. The layout matches shaders/Leaf.vertex.glsl
+//----------------------------------------------------------------------------------------------------------------------
+typedef struct LeafInstance
+{
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The position of the leaf, at attribute location 3
+		//----------------------------------------------------------------------------------------------------------------------
+		ngl::Vec3 m_position;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The rotation of the leaf model, at attribute location 4 as a vec4 with the scalar part first
+		//----------------------------------------------------------------------------------------------------------------------
+		Quaternion m_orientation;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The uniform scale of the leaf, at attribute location 5
+		//----------------------------------------------------------------------------------------------------------------------
+		float m_scale;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor
+		//----------------------------------------------------------------------------------------------------------------------
+		LeafInstance(const ngl::Vec3& _position, const Quaternion& _orientation, float _scale) :
+			m_position(_position),
+			m_orientation(_orientation),
+			m_scale(_scale){}
+} LeafInstance;
+
+#endif // LEAFINSTANCE_H_
@@ -88,6 +88,20 @@ class MainWindow : public QMainWindow
 		/// @param _state The visibility state to set
 		//----------------------------------------------------------------------------------------------------------------------
 		void setPlantVisibility(unsigned _index, bool _state);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Show or hide the frame statistics overlay
+		/// @param _state The new overlay state
+		//----------------------------------------------------------------------------------------------------------------------
+		void showStats(bool _state);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Set the distance beyond which plants are drawn as impostors
+		/// @param _distance The new distance
+		//----------------------------------------------------------------------------------------------------------------------
+		void setImpostorDistance(double _distance);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Ask for a file name and export the frame statistics as CSV
+		//----------------------------------------------------------------------------------------------------------------------
+		void exportStats();
 
 	private:
 		//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,157 @@
+#ifndef MESH_H_
+#define MESH_H_
+
+#include <cstddef>
+#include <vector>
+#include <ngl/Types.h>
+#include <ngl/Vec2.h>
+#include <ngl/Vec3.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file Mesh.h
+/// @brief This class stores indexed triangle geometry on the GPU
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 16/05/17
+/// @struct Vertex
+/// @brief Struct to contain one interleaved vertex. The layout matches the attribute locations in the shaders
+//----------------------------------------------------------------------------------------------------------------------
+typedef struct Vertex
+{
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The position, at attribute location 0
+		//----------------------------------------------------------------------------------------------------------------------
+		ngl::Vec3 m_position;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The texture coordinate, at attribute location 1
+		//----------------------------------------------------------------------------------------------------------------------
+		ngl::Vec2 m_uv;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The normal, at attribute location 2
+		//----------------------------------------------------------------------------------------------------------------------
+		ngl::Vec3 m_normal;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor
+		//----------------------------------------------------------------------------------------------------------------------
+		Vertex(const ngl::Vec3& _position, const ngl::Vec2& _uv, const ngl::Vec3& _normal) :
+			m_position(_position),
+			m_uv(_uv),
+			m_normal(_normal){}
+} Vertex;
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @class Mesh
+/// @brief This class owns a vertex buffer and an index buffer
+/// The buffers are only created on the first upload, so a Mesh can be constructed without a GL context
+//----------------------------------------------------------------------------------------------------------------------
+class Mesh
+{
+	public:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor
+		//----------------------------------------------------------------------------------------------------------------------
+		Mesh(){}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Destructor. This deletes the GL buffers, so it must be called with a valid GL context
+		//----------------------------------------------------------------------------------------------------------------------
+		~Mesh();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Delete copy constructor since this owns GL buffers
+		//----------------------------------------------------------------------------------------------------------------------
+		Mesh(const Mesh&) = delete;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Delete copy assignment since this owns GL buffers
+		//----------------------------------------------------------------------------------------------------------------------
+		Mesh& operator=(const Mesh&) = delete;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Move constructor. The buffers are transferred to this object
+		/// @param _other The mesh to move from
+		//----------------------------------------------------------------------------------------------------------------------
+		Mesh(Mesh&& _other);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Move assignment. The buffers are transferred to this object
+		/// @param _other The mesh to move from
+		//----------------------------------------------------------------------------------------------------------------------
+		Mesh& operator=(Mesh&& _other);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Upload the geometry to the GPU, replacing any previous data
+		/// @param _vertices The interleaved vertices
+		/// @param _indices The triangle indices
+		//----------------------------------------------------------------------------------------------------------------------
+		void setData(const std::vector<Vertex>& _vertices, const std::vector<GLuint>& _indices);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Upload the geometry to the GPU, only copying the data that was added since the last upload
+		/// The buffers grow geometrically, so appending a little geometry rarely needs a full upload
+		/// @param _vertices The interleaved vertices
+		/// @param _indices The triangle indices
+		/// @param _firstVertex The first vertex that has not been uploaded yet
+		/// @param _firstIndex The first index that has not been uploaded yet
+		//----------------------------------------------------------------------------------------------------------------------
+		void appendData(const std::vector<Vertex>& _vertices, const std::vector<GLuint>& _indices, std::size_t _firstVertex, std::size_t _firstIndex);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Bind the buffers and set the vertex attributes on the currently bound vertex array
+		/// This is used by InstanceBuffer to share the geometry between many vertex arrays
+		//----------------------------------------------------------------------------------------------------------------------
+		void bindAttributes() const;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Draw the mesh once
+		//----------------------------------------------------------------------------------------------------------------------
+		void draw() const;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Draw parts of the mesh with one draw call
+		/// @param _counts The number of indices in each part
+		/// @param _offsets The byte offset of the first index of each part
+		//----------------------------------------------------------------------------------------------------------------------
+		void drawRanges(const std::vector<GLsizei>& _counts, const std::vector<const GLvoid*>& _offsets) const;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for m_indexCount
+		/// @return The number of indices to draw
+		//----------------------------------------------------------------------------------------------------------------------
+		GLsizei indexCount() const {return m_indexCount;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Generate a square of size 1 on the xz plane, centred at the origin and facing up
+		/// @param _vertices The container to add vertices to
+		/// @param _indices The container to add indices to
+		//----------------------------------------------------------------------------------------------------------------------
+		static void createPlane(std::vector<Vertex>& _vertices, std::vector<GLuint>& _indices);
+
+	private:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Vertex array used when drawing the mesh on its own
+		//----------------------------------------------------------------------------------------------------------------------
+		GLuint m_vao = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Vertex buffer
+		//----------------------------------------------------------------------------------------------------------------------
+		GLuint m_vbo = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Index buffer
+		//----------------------------------------------------------------------------------------------------------------------
+		GLuint m_ibo = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of indices in the index buffer
+		//----------------------------------------------------------------------------------------------------------------------
+		GLsizei m_indexCount = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of vertices the vertex buffer can hold
+		//----------------------------------------------------------------------------------------------------------------------
+		std::size_t m_vertexCapacity = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of indices the index buffer can hold
+		//----------------------------------------------------------------------------------------------------------------------
+		std::size_t m_indexCapacity = 0;
+
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Copy data to the end of a buffer, reallocating the whole buffer if it is too small
+		/// @param _target The buffer target to bind to
+		/// @param _buffer The buffer handle
+		/// @param _data Pointer to the start of all the data
+		/// @param _elementSize The size in bytes of one element
+		/// @param _count The total number of elements
+		/// @param _first The first element that has not been uploaded yet
+		/// @param _capacity The number of elements the buffer can hold. This is updated if the buffer grows
+		//----------------------------------------------------------------------------------------------------------------------
+		static void appendToBuffer(GLenum _target, GLuint _buffer, const void* _data, std::size_t _elementSize, std::size_t _count, std::size_t _first, std::size_t& _capacity);
+};
+
+#endif // MESH_H_
@@ -0,0 +1,138 @@
+#ifndef MODULESTRING_H_
+#define MODULESTRING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file ModuleString.h
+/// @brief This class is a compact L-system string of symbol ids and their parameters
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 23/05/17
+/// @class ModuleString
+/// @brief This class stores each module as an 8 bit symbol id from the blueprint Alphabet
+/// The parameters of all the modules are packed in one array, in module order. The number of parameters of a module
+/// is the arity of its symbol in the alphabet, so modules without parameters cost a single byte
+//----------------------------------------------------------------------------------------------------------------------
+class ModuleString
+{
+	public:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for the number of modules
+		/// @return The number of modules
+		//----------------------------------------------------------------------------------------------------------------------
+		std::size_t size() const {return m_symbols.size();}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Check if there are no modules
+		/// @return True if there are no modules
+		//----------------------------------------------------------------------------------------------------------------------
+		bool empty() const {return m_symbols.empty();}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get the symbol of a module
+		/// @param _index The index of the module
+		/// @return The symbol id
+		//----------------------------------------------------------------------------------------------------------------------
+		uint8_t operator[](std::size_t _index) const {return m_symbols[_index];}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for m_symbols
+		/// @return Reference to the symbol ids
+		//----------------------------------------------------------------------------------------------------------------------
+		const std::vector<uint8_t>& symbols() const {return m_symbols;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for m_parameters
+		/// @return Reference to the packed parameters
+		//----------------------------------------------------------------------------------------------------------------------
+		const std::vector<float>& parameters() const {return m_parameters;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Allocate space for modules before appending them
+		/// @param _symbols The number of modules
+		/// @param _parameters The number of parameters
+		//----------------------------------------------------------------------------------------------------------------------
+		void reserve(std::size_t _symbols, std::size_t _parameters = 0)
+		{
+			m_symbols.reserve(_symbols);
+			m_parameters.reserve(_parameters);
+		}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Remove all the modules, keeping the allocations
+		//----------------------------------------------------------------------------------------------------------------------
+		void clear()
+		{
+			m_symbols.clear();
+			m_parameters.clear();
+		}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Add a module without parameters
+		/// @param _symbol The symbol id
+		//----------------------------------------------------------------------------------------------------------------------
+		void append(uint8_t _symbol) {m_symbols.push_back(_symbol);}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Add a module with parameters
+		/// @param _symbol The symbol id
+		/// @param _parameters The parameters, which must match the arity of the symbol
+		/// @param _count The number of parameters
+		//----------------------------------------------------------------------------------------------------------------------
+		void append(uint8_t _symbol, const float* _parameters, std::size_t _count)
+		{
+			m_symbols.push_back(_symbol);
+			m_parameters.insert(m_parameters.end(), _parameters, _parameters + _count);
+		}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Add all the modules of another string
+		/// @param _modules The modules to add
+		//----------------------------------------------------------------------------------------------------------------------
+		void append(const ModuleString& _modules)
+		{
+			m_symbols.insert(m_symbols.end(), _modules.m_symbols.begin(), _modules.m_symbols.end());
+			m_parameters.insert(m_parameters.end(), _modules.m_parameters.begin(), _modules.m_parameters.end());
+		}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Add a range of the modules of another string
+		/// The caller tracks where the parameters of the range start, as that depends on the arities of the symbols before it
+		/// @param _modules The modules to add from
+		/// @param _begin The first module
+		/// @param _end One past the last module
+		/// @param _firstParameter The index of the first parameter of the range
+		/// @param _parameterCount The number of parameters of the range
+		//----------------------------------------------------------------------------------------------------------------------
+		void append(const ModuleString& _modules, std::size_t _begin, std::size_t _end, std::size_t _firstParameter, std::size_t _parameterCount)
+		{
+			m_symbols.insert(m_symbols.end(), _modules.m_symbols.begin() + _begin, _modules.m_symbols.begin() + _end);
+			auto parameters = _modules.m_parameters.begin() + _firstParameter;
+			m_parameters.insert(m_parameters.end(), parameters, parameters + _parameterCount);
+		}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Set a parameter
+		/// @param _index The index of the parameter in the packed parameters
+		/// @param _value The value
+		//----------------------------------------------------------------------------------------------------------------------
+		void setParameter(std::size_t _index, float _value) {m_parameters[_index] = _value;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Count the modules with a symbol
+		/// @param _symbol The symbol id
+		/// @return The number of modules
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned count(uint8_t _symbol) const
+		{
+			unsigned count = 0;
+			for (uint8_t s : m_symbols)
+			{
+				if (s == _symbol) ++count;
+			}
+			return count;
+		}
+
+	private:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The symbol id of each module
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<uint8_t> m_symbols;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The parameters of all the modules, packed in module order
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<float> m_parameters;
+};
+
+#endif // MODULESTRING_H_
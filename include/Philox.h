@@ -0,0 +1,115 @@
+#ifndef PHILOX_H_
+#define PHILOX_H_
+
+#include <array>
+#include <cstdint>
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file Philox.h
+/// @brief A counter based random number generator
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 23/05/17
+/// @class Philox
+/// @brief This class is the Philox4x32-10 generator from Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3"
+/// Each block of random numbers is a pure function of a key and a counter, so there is no state shared between
+/// branches and any branch can be evaluated on any thread, in any order, and give the same numbers.
+/// The key is the plant seed and the branch id. The counter is the node index, the purpose of the numbers and the
+/// number of blocks drawn so far
+//----------------------------------------------------------------------------------------------------------------------
+class Philox
+{
+	public:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief enum for what the numbers are used for, so different uses at the same node don't share numbers
+		//----------------------------------------------------------------------------------------------------------------------
+		enum PURPOSE : uint32_t {GROWTH = 0, LEAVES = 1, REWRITE = 2};
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor
+		/// @param _seed The plant seed
+		/// @param _branch The branch id, or the number of the rewrite when rewriting
+		/// @param _node The index of the node in the branch, or of the module when rewriting
+		/// @param _purpose What the numbers are used for
+		//----------------------------------------------------------------------------------------------------------------------
+		Philox(uint32_t _seed, uint32_t _branch, uint32_t _node, PURPOSE _purpose) :
+			m_key{{_seed, _branch}},
+			m_counter{{_node, _purpose, 0, 0}}{}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Generate the next random float
+		/// @return Random float in the range [0,1)
+		//----------------------------------------------------------------------------------------------------------------------
+		float generateFloat()
+		{
+			//Generate four numbers at a time
+			if (m_used == 4)
+			{
+				m_block = generateBlock(m_counter, m_key);
+				++m_counter[2];
+				m_used = 0;
+			}
+			//Use the top 24 bits, which is all a float can represent in [0,1)
+			return (m_block[m_used++] >> 8) * (1.0f / 16777216.0f);
+		}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Generate a block of four random numbers
+		/// @param _counter The counter
+		/// @param _key The key
+		/// @return The random numbers
+		//----------------------------------------------------------------------------------------------------------------------
+		static std::array<uint32_t, 4> generateBlock(std::array<uint32_t, 4> _counter, std::array<uint32_t, 2> _key)
+		{
+			for (unsigned i=0; i<s_rounds; ++i)
+			{
+				uint64_t product0 = static_cast<uint64_t>(s_multiplier0) * _counter[0];
+				uint64_t product1 = static_cast<uint64_t>(s_multiplier1) * _counter[2];
+				_counter = {{static_cast<uint32_t>(product1 >> 32) ^ _counter[1] ^ _key[0],
+										 static_cast<uint32_t>(product1),
+										 static_cast<uint32_t>(product0 >> 32) ^ _counter[3] ^ _key[1],
+										 static_cast<uint32_t>(product0)}};
+				//Bump the key between rounds
+				_key[0] += s_weyl0;
+				_key[1] += s_weyl1;
+			}
+			return _counter;
+		}
+
+	private:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of rounds. Ten is the number recommended by the authors
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr unsigned s_rounds = 10;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The multiplier of the first half of the counter
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr uint32_t s_multiplier0 = 0xD2511F53;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The multiplier of the second half of the counter
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr uint32_t s_multiplier1 = 0xCD9E8D57;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The increment of the first key, from the golden ratio
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr uint32_t s_weyl0 = 0x9E3779B9;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The increment of the second key, from sqrt(3)-1
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr uint32_t s_weyl1 = 0xBB67AE85;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The key
+		//----------------------------------------------------------------------------------------------------------------------
+		std::array<uint32_t, 2> m_key;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The counter of the next block
+		//----------------------------------------------------------------------------------------------------------------------
+		std::array<uint32_t, 4> m_counter;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The current block of numbers
+		//----------------------------------------------------------------------------------------------------------------------
+		std::array<uint32_t, 4> m_block;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of numbers used from the current block
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_used = 4;
+};
+
+#endif // PHILOX_H_
@@ -1,14 +1,26 @@
 #ifndef PLANT_H_
 #define PLANT_H_
 
+#include <array>
 #include <random>
 #include <string>
+#include <utility>
 #include <vector>
 #include <ngl/Mat4.h>
 #include <ngl/Vec3.h>
+#include "AABB.h"
 #include "Branch.h"
+#include "Frustum.h"
+#include "Impostor.h"
+#include "LeafInstance.h"
+#include "LODGeometry.h"
+#include "ModuleString.h"
+#include "Philox.h"
 #include "PlantBlueprint.h"
+#include "PlantGeometry.h"
+#include "PlantScratch.h"
 #include "ProductionRule.h"
+#include "Quaternion.h"
 
 //----------------------------------------------------------------------------------------------------------------------
 /// @file Plant.h
@@ -30,15 +42,69 @@ class Plant
 		//----------------------------------------------------------------------------------------------------------------------
 		Plant(const std::string& _blueprint, const ngl::Vec3& _position);
 		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor for a plant with a known seed
+		/// Plants with the same blueprint, position and seed grow identically, so a plant can be regenerated from its seed
+		/// @param _blueprint The name of the PlantBlueprint that this object uses
+		/// @param _position The position of the Plant on the ground. Note that the y coordinate is always 0 to be on the ground
+		/// @param _seed The seed of the random numbers used to grow the plant
+		//----------------------------------------------------------------------------------------------------------------------
+		Plant(const std::string& _blueprint, const ngl::Vec3& _position, uint32_t _seed);
+		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Destructor
 		//----------------------------------------------------------------------------------------------------------------------
 		~Plant();
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief Draw the plant
-		/// @param _viewMatrix The view matrix from the camera
-		/// @param _projectionMatrix The projection matrix from the camera
+		/// @brief Delete copy constructor since this owns GL buffers
+		//----------------------------------------------------------------------------------------------------------------------
+		Plant(const Plant&) = delete;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Delete copy assignment since this owns GL buffers
+		//----------------------------------------------------------------------------------------------------------------------
+		Plant& operator=(const Plant&) = delete;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Move constructor, needed to store plants in a container
+		//----------------------------------------------------------------------------------------------------------------------
+		Plant(Plant&&) = default;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Move assignment, needed to erase plants from a container
+		//----------------------------------------------------------------------------------------------------------------------
+		Plant& operator=(Plant&&) = default;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Cull the plant and its branches against the camera frustum and upload any changed geometry
+		/// This is called for every plant before the bark and leaf passes, so each shader is only bound once per frame
+		/// @param _frustum The camera frustum to cull the plant and its branches against
+		/// @return False if the plant is outside the frustum and should not be drawn
+		//----------------------------------------------------------------------------------------------------------------------
+		bool prepareDraw(const Frustum& _frustum);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Draw the branches that were found visible by prepareDraw
+		/// This must be called after PlantBlueprint::beginBarkPass
+		//----------------------------------------------------------------------------------------------------------------------
+		void drawBark() const;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Draw the leaves that were found visible by prepareDraw
+		/// This must be called after PlantBlueprint::beginLeafPass
+		//----------------------------------------------------------------------------------------------------------------------
+		void drawLeaves() const;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Draw the whole plant at a level of detail without culling
+		/// This is used to capture impostors
+		/// @param _lod The level of detail to draw
+		/// @param _viewMatrix The view matrix
+		/// @param _projectionMatrix The projection matrix
+		/// @param _eye The camera position
+		//----------------------------------------------------------------------------------------------------------------------
+		void drawUnculled(unsigned _lod, const ngl::Mat4 _viewMatrix, const ngl::Mat4 _projectionMatrix, const ngl::Vec3& _eye);
 		//----------------------------------------------------------------------------------------------------------------------
-		void draw(const ngl::Mat4 _viewMatrix, const ngl::Mat4 _projectionMatrix);
+		/// @brief Seed the generator that seeds each new plant, so a run can be repeated
+		/// @param _seed The seed
+		//----------------------------------------------------------------------------------------------------------------------
+		static void seed(unsigned _seed) {s_seedGenerator.seed(_seed);}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for the seed of this plant
+		/// @return The seed
+		//----------------------------------------------------------------------------------------------------------------------
+		uint32_t plantSeed() const {return m_seed;}
 		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Update function to evaluate the Plant simulation
 		//----------------------------------------------------------------------------------------------------------------------
@@ -53,6 +119,38 @@ class Plant
 		/// @return The visibility state
 		//----------------------------------------------------------------------------------------------------------------------
 		const bool& visibility() const {return m_isVisible;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for the bounding box
+		/// @return The bounding box of all the branches and leaves
+		//----------------------------------------------------------------------------------------------------------------------
+		const AABB& bounds() const {return m_bounds;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Choose the level of detail and whether to use an impostor from the distance to the camera
+		/// The thresholds have a margin either side so plants near a threshold don't switch every frame
+		/// @param _eye The camera position
+		/// @param _impostorDistance The distance beyond which the plant is drawn as an impostor
+		//----------------------------------------------------------------------------------------------------------------------
+		void updateLOD(const ngl::Vec3& _eye, float _impostorDistance);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for the level of detail
+		/// @return The current level of detail, where 0 is the most detailed
+		//----------------------------------------------------------------------------------------------------------------------
+		const unsigned& lod() const {return m_lod;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for whether the plant is far enough to be drawn as an impostor
+		/// @return True if the plant should be drawn as an impostor
+		//----------------------------------------------------------------------------------------------------------------------
+		const bool& isImpostor() const {return m_isImpostor;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for the impostor handle
+		/// @return Reference to the impostor handle
+		//----------------------------------------------------------------------------------------------------------------------
+		const ImpostorHandle& impostor() const {return m_impostor;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for the impostor handle, used by the ImpostorAtlas to assign a layer
+		/// @return Reference to the impostor handle
+		//----------------------------------------------------------------------------------------------------------------------
+		ImpostorHandle& impostor() {return m_impostor;}
 
 	private:
 		//----------------------------------------------------------------------------------------------------------------------
@@ -74,13 +172,28 @@ class Plant
 		//----------------------------------------------------------------------------------------------------------------------
 		static std::random_device s_randomDevice;
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief Static mersenne twister algorithm
+		/// @brief Static mersenne twister used to seed each plant as it is created
+		/// This is only used in the constructor, which is called on one thread
+		//----------------------------------------------------------------------------------------------------------------------
+		static std::mt19937 s_seedGenerator;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The seed of this plant
+		/// All the random numbers are generated from this, the branch id and the node index, see Philox
+		//----------------------------------------------------------------------------------------------------------------------
+		uint32_t m_seed;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of branches created, used to give each branch an id
 		//----------------------------------------------------------------------------------------------------------------------
-		static std::mt19937 s_numberGenerator;
+		unsigned m_branchCount = 0;
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief The L-system string
+		/// @brief The number of times the modules have been rewritten, used to key the choices of stochastic rules
+		/// This can be more than the depth, as a rewrite that doesn't draw anything new is repeated
 		//----------------------------------------------------------------------------------------------------------------------
-		std::string m_string;
+		unsigned m_rewriteCount = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The L-system string, encoded with the blueprint alphabet
+		//----------------------------------------------------------------------------------------------------------------------
+		ModuleString m_modules;
 		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief The current depth of the L-system string expansion
 		//----------------------------------------------------------------------------------------------------------------------
@@ -90,48 +203,75 @@ class Plant
 		//----------------------------------------------------------------------------------------------------------------------
 		std::vector<Branch> m_branches;
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief Transformation for draw calls
+		/// @brief The nodes and leaves of every branch, which each branch has a range of
 		//----------------------------------------------------------------------------------------------------------------------
-		ngl::Mat4 m_transform;
-
+		PlantGeometry m_geometry;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The temporary buffers of the updates, which keep their memory from one update to the next
+		//----------------------------------------------------------------------------------------------------------------------
+		PlantScratch m_scratch;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of levels of detail
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr unsigned s_lodCount = 3;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The settings of each level of detail, from the most to the least detailed
+		//----------------------------------------------------------------------------------------------------------------------
+		static const std::array<LODSettings, s_lodCount> s_lodSettings;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The fraction of the distance threshold used as a margin to avoid popping
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr float s_lodHysteresis = 0.1f;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The geometry of each level of detail
+		/// The most detailed level is appended to as branches are evaluated and the others are rebuilt when first needed
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<LODGeometry> m_lods;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The current level of detail
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_lod = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Flag for whether the plant is drawn as an impostor
+		//----------------------------------------------------------------------------------------------------------------------
+		bool m_isImpostor = false;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Where the impostor of the plant is stored
+		//----------------------------------------------------------------------------------------------------------------------
+		ImpostorHandle m_impostor;
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief Calculate and load the matrices to the shader
-		/// @param _viewMatrix The view matrix from the camera
-		/// @param _projectionMatrix The projection matrix from the camera
+		/// @brief Bounding box of all the branches and leaves
 		//----------------------------------------------------------------------------------------------------------------------
-		void loadMatricesToShader(const ngl::Mat4 _viewMatrix, const ngl::Mat4 _projectionMatrix) const;
+		AABB m_bounds;
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief Calculate axis-angle rotation matrix
-		/// @param _angle The angle to rotate in radians
-		/// @param _axis The axis to rotate around
-		/// This is a function "euler" in ngl::Mat4, but this is reimplemented to avoid converting from radians to degrees and back to radians
-		/// Since this is called multiple times in one draw call, it saves a lot of divide operations
+		/// @brief The number of indices in each visible range of the tube mesh
+		/// This is a member so the memory is reused between frames
 		//----------------------------------------------------------------------------------------------------------------------
-		ngl::Mat4 axisAngleRotationMatrix(const float& _angle, const ngl::Vec3& _axis) const;
+		std::vector<GLsizei> m_visibleIndexCounts;
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief Generate a random number
-		/// This is used for stochastic L-systems during string rewriting.
-		/// It is also used for space colonisation to generate random points.
-		/// @return Random float in the range [0,1]
+		/// @brief The byte offset of each visible range of the tube mesh
 		//----------------------------------------------------------------------------------------------------------------------
-		float generateRandomFloat() const;
+		std::vector<const GLvoid*> m_visibleIndexOffsets;
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief Count the number of occurrences of a char in a string
-		/// @param _string The string to check from
-		/// @param _char The character to check for
-		/// @return The number of occurrences of the char
+		/// @brief The first instance and number of instances of each visible range of leaves
 		//----------------------------------------------------------------------------------------------------------------------
-		unsigned countCharInString(const std::string& _string, const char& _c) const;
+		std::vector<std::pair<unsigned, unsigned>> m_visibleLeafRanges;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Flag for whether only the visible ranges are drawn, set by prepareDraw
+		//----------------------------------------------------------------------------------------------------------------------
+		bool m_isPartiallyVisible = false;
+
 		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Add branches to the container
-		/// @param _number The number of branches to add
-		/// @param _position The position in the container to add at
+		/// The existing branches and the new ones are merged into a new container in one pass, rather than inserting each new
+		/// branch in the middle and moving every branch after it
+		/// @param _positions The index of each new branch in the final container, in increasing order
 		//----------------------------------------------------------------------------------------------------------------------
-		void addBranches(const unsigned& _number, unsigned& _position);
+		void addBranches(const std::vector<unsigned>& _positions);
 		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Convert the string to branches
 		/// This is used once to initialise the container of branches,
-		/// and once per update to populate the strings in each struct
+		/// and once per update to refresh the span of modules of each branch in one pass
 		//----------------------------------------------------------------------------------------------------------------------
 		void stringToBranches();
 		//----------------------------------------------------------------------------------------------------------------------
@@ -139,6 +279,12 @@ class Plant
 		//----------------------------------------------------------------------------------------------------------------------
 		void stringRewrite();
 		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Derive the L-system to the max depth and evaluate the branches as the modules are derived
+		/// The string is never stored, so the memory used is the geometry and not the exponentially growing string.
+		/// The plant is fully grown afterwards, so updateSimulation does nothing
+		//----------------------------------------------------------------------------------------------------------------------
+		void streamDerivation();
+		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Calculate a scalar decay value
 		/// @return Float in the range [0,1]
 		/// This is used to shorten branches, and must be multiplied to a length
@@ -149,21 +295,65 @@ class Plant
 		/// @param _startPos The start position of the branch
 		/// @param _endPos The end position of the branch
 		/// @param _radius The radius of the branch
-		/// @param _direction The direction of the branch
+		/// @param _frame The turtle frame of the branch segment, which the leaves take their orientation from
 		/// @param _branch The branch to add to
 		//----------------------------------------------------------------------------------------------------------------------
-		void scatterLeaves(Branch& _branch, const ngl::Vec3& _startPos, const ngl::Vec3& _endPos, const float _radius, const ngl::Vec3& _direction);
+		void scatterLeaves(Branch& _branch, const ngl::Vec3& _startPos, const ngl::Vec3& _endPos, const float _radius, const Quaternion& _frame);
 		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Calculate the branch positions using space colonisation
 		/// @param _branch A reference to the branch to calculate
-		/// @param _direction The direction to perform space colonisation in
+		/// @param _frame The turtle frame to perform space colonisation in, which is turned to follow the new nodes
+		/// @param _length The length of the branch segment
 		//----------------------------------------------------------------------------------------------------------------------
-		void spaceColonisation(Branch& _branch, ngl::Vec3& _direction);
+		void spaceColonisation(Branch& _branch, Quaternion& _frame, float _length);
 		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Evaluate the L-system string to calculate branches
 		/// This is calculated once per L-system update as it is an expensive operation
 		//----------------------------------------------------------------------------------------------------------------------
 		void evaluateBranches();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Evaluate the modules of a new branch with the turtle, grow its nodes and bake its geometry
+		/// @param _branch The branch
+		/// @param _modules The modules the span of the branch is in
+		/// @param _position The start position of the branch
+		/// @param _frame The start turtle frame of the branch
+		//----------------------------------------------------------------------------------------------------------------------
+		void evaluateBranch(Branch& _branch, const ModuleString& _modules, const ngl::Vec3& _position, Quaternion _frame);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Bake the tube geometry and leaf instances of a newly evaluated branch
+		/// Existing branches never change, and the draw order does not matter, so the new geometry is appended.
+		/// The data is uploaded on the next draw
+		/// @param _branch The branch to add the geometry of
+		//----------------------------------------------------------------------------------------------------------------------
+		void bakeBranch(Branch& _branch);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get the last node of a branch
+		/// @param _branch The branch, which must have been evaluated
+		/// @return The position of the node
+		//----------------------------------------------------------------------------------------------------------------------
+		ngl::Vec3 lastNode(const Branch& _branch) const {return m_geometry.m_nodes[_branch.m_firstNode + _branch.m_nodeCount - 1];}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get the turtle frame at the last node of a branch
+		/// @param _branch The branch, which must have been evaluated
+		/// @return Reference to the frame
+		//----------------------------------------------------------------------------------------------------------------------
+		const Quaternion& lastFrame(const Branch& _branch) const {return m_geometry.m_nodeFrames[_branch.m_firstNode + _branch.m_nodeCount - 1];}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Rebuild the geometry of a simplified level of detail from all the branches
+		/// @param _lod The level of detail to rebuild, which must be greater than 0
+		//----------------------------------------------------------------------------------------------------------------------
+		void buildLOD(unsigned _lod);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Build and upload the geometry of a level of detail if it has changed
+		/// @param _lod The level of detail
+		//----------------------------------------------------------------------------------------------------------------------
+		void prepareGeometry(unsigned _lod);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Find the ranges of branches and leaves that are inside the frustum
+		/// Neighbouring branches in the buffers are merged into one range
+		/// @param _frustum The camera frustum
+		//----------------------------------------------------------------------------------------------------------------------
+		void findVisibleRanges(const Frustum& _frustum);
 
 };
 
@@ -6,9 +6,18 @@
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
-#include <ngl/Obj.h>
+#include <utility>
+#include <ngl/Mat4.h>
 #include <ngl/ShaderLib.h>
+#include <ngl/Vec3.h>
+#include "Alphabet.h"
+#include "InstanceBuffer.h"
+#include "Mesh.h"
+#include "ModuleString.h"
 #include "ProductionRule.h"
+#include "RuleTable.h"
+#include "TubeMesh.h"
+#include "TurtleTable.h"
 
 //----------------------------------------------------------------------------------------------------------------------
 /// @file PlantBlueprint.h
@@ -46,13 +55,51 @@ class PlantBlueprint
 		//----------------------------------------------------------------------------------------------------------------------
 		static void init();
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief Draw the cylinder
+		/// @brief Bind the bark shader and texture and load the camera matrices, ready to draw the branches of every plant
+		/// The branch meshes are already in world space, so the model matrix is the identity and the matrices are shared
+		/// @param _viewMatrix The view matrix from the camera
+		/// @param _projectionMatrix The projection matrix from the camera
+		/// @param _eye The camera position
 		//----------------------------------------------------------------------------------------------------------------------
-		static void drawCylinder();
+		static void beginBarkPass(const ngl::Mat4& _viewMatrix, const ngl::Mat4& _projectionMatrix, const ngl::Vec3& _eye);
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief Draw the leaf
+		/// @brief Bind the leaf shader and texture and load the camera matrices, ready to draw the leaves of every plant
+		/// The model matrices are built from per-instance attributes, so the camera matrices are the only ones needed.
+		/// This disables face culling until endLeafPass
+		/// @param _viewMatrix The view matrix from the camera
+		/// @param _projectionMatrix The projection matrix from the camera
+		/// @param _eye The camera position
 		//----------------------------------------------------------------------------------------------------------------------
-		static void drawLeaf();
+		static void beginLeafPass(const ngl::Mat4& _viewMatrix, const ngl::Mat4& _projectionMatrix, const ngl::Vec3& _eye);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Re-enable face culling after the leaves
+		//----------------------------------------------------------------------------------------------------------------------
+		static void endLeafPass() {glEnable(GL_CULL_FACE);}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Draw the branches of a plant. This must be called after beginBarkPass
+		/// @param _mesh The tube mesh containing all the branches of the plant
+		//----------------------------------------------------------------------------------------------------------------------
+		static void drawBark(const TubeMesh& _mesh);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Draw some of the branches of a plant with the bark texture
+		/// This is used when a plant is partially visible
+		/// @param _mesh The tube mesh containing all the branches of the plant
+		/// @param _counts The number of indices in each visible range
+		/// @param _offsets The byte offset of the first index of each visible range
+		//----------------------------------------------------------------------------------------------------------------------
+		static void drawBark(const TubeMesh& _mesh, const std::vector<GLsizei>& _counts, const std::vector<const GLvoid*>& _offsets);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Draw instances of the leaf with one draw call. This must be called after beginLeafPass
+		/// @param _instances The instance buffer containing the position, orientation and scale of each leaf
+		//----------------------------------------------------------------------------------------------------------------------
+		static void drawLeaves(const InstanceBuffer& _instances);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Draw some of the leaf instances
+		/// This is used when a plant is partially visible
+		/// @param _instances The instance buffer containing the position, orientation and scale of each leaf
+		/// @param _ranges The first instance and number of instances of each visible range
+		//----------------------------------------------------------------------------------------------------------------------
+		static void drawLeaves(const InstanceBuffer& _instances, const std::vector<std::pair<unsigned, unsigned>>& _ranges);
 		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Set function for m_axiom
 		/// @param _axiom The L-system axiom
@@ -72,7 +119,7 @@ class PlantBlueprint
 		/// @brief Set function for m_drawAngle
 		/// @param _angle New angle to rotate
 		//----------------------------------------------------------------------------------------------------------------------
-		void setDrawAngle(float _angle){m_drawAngle = _angle;}
+		void setDrawAngle(float _angle){m_drawAngle = _angle; m_turtleTable.build(_angle);}
 		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Set function for m_drawLength
 		/// @param _length New default draw length
@@ -124,11 +171,27 @@ class PlantBlueprint
 		//----------------------------------------------------------------------------------------------------------------------
 		void setGravitropismScaleFactor(float _scaleFactor){m_gravitropismScaleFactor = _scaleFactor;}
 		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Set function for m_streamDerivation
+		/// @param _isStreamed Whether new plants are derived to the max depth without storing the L-system string
+		/// This warns once and leaves streaming off if the current rules can't be streamed
+		//----------------------------------------------------------------------------------------------------------------------
+		void setStreamDerivation(bool _isStreamed);
+		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Get function for m_axiom
 		/// @return Reference of the axiom for the L-system
 		//----------------------------------------------------------------------------------------------------------------------
 		const std::string& axiom() const {return m_axiom;}
 		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for m_axiomModules
+		/// @return Reference to the L-system axiom encoded with the alphabet
+		//----------------------------------------------------------------------------------------------------------------------
+		const ModuleString& axiomModules() const {return m_axiomModules;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for m_alphabet
+		/// @return Reference to the symbols of the L-system
+		//----------------------------------------------------------------------------------------------------------------------
+		const Alphabet& alphabet() const {return m_alphabet;}
+		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Get function for m_maxDepth
 		/// @return Reference of the max depth of the L-system
 		//----------------------------------------------------------------------------------------------------------------------
@@ -139,6 +202,11 @@ class PlantBlueprint
 		//----------------------------------------------------------------------------------------------------------------------
 		const std::vector<ProductionRule>& productionRules() const {return m_productionRules;}
 		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for m_ruleTable
+		/// @return Reference to the production rules compiled for rewriting
+		//----------------------------------------------------------------------------------------------------------------------
+		const RuleTable& ruleTable() const {return m_ruleTable;}
+		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Get function for m_drawLength
 		/// @return Reference to the draw length
 		//----------------------------------------------------------------------------------------------------------------------
@@ -149,6 +217,11 @@ class PlantBlueprint
 		//----------------------------------------------------------------------------------------------------------------------
 		const float& drawAngle() const {return m_drawAngle;}
 		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for m_turtleTable
+		/// @return Reference to the rotations of the turtle symbols by the draw angle
+		//----------------------------------------------------------------------------------------------------------------------
+		const TurtleTable& turtleTable() const {return m_turtleTable;}
+		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Get function for m_rootRadius
 		/// @return Reference to the initial radius
 		//----------------------------------------------------------------------------------------------------------------------
@@ -194,17 +267,32 @@ class PlantBlueprint
 		//----------------------------------------------------------------------------------------------------------------------
 		const float& gravitropismScaleFactor() const {return m_gravitropismScaleFactor;}
 		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for m_streamDerivation
+		/// @return True if new plants are streamed
+		//----------------------------------------------------------------------------------------------------------------------
+		bool streamDerivation() const {return m_streamDerivation;}
+		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Get function for s_keys
 		/// @return Reference to the keys of the map, i.e. the names of the instances
 		/// This is used for the UI
 		//----------------------------------------------------------------------------------------------------------------------
 		static const std::unordered_set<std::string>& keys(){return s_keys;}
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief Get function for the shader name
-		/// @return Reference to the shader name
-		/// This is needed for draw calls
+		/// @brief Get function for the bark shader name
+		/// @return Reference to the bark shader name
+		//----------------------------------------------------------------------------------------------------------------------
+		static const std::string& barkShaderName(){return s_barkShaderProgramName;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for the leaf shader name
+		/// @return Reference to the leaf shader name
 		//----------------------------------------------------------------------------------------------------------------------
-		static const std::string& shaderName(){return s_shaderProgramName;}
+		static const std::string& leafShaderName(){return s_leafShaderProgramName;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for the leaf mesh
+		/// @return Reference to the leaf mesh
+		/// This is needed to create instance buffers of the leaf
+		//----------------------------------------------------------------------------------------------------------------------
+		static const Mesh& leaf(){return *s_leaf;}
 		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Get function for the sun position
 		/// @return Reference to the sun position
@@ -234,17 +322,23 @@ class PlantBlueprint
 		//----------------------------------------------------------------------------------------------------------------------
 		static std::unordered_set<std::string> s_keys;
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief Handle for the shader name
+		/// @brief Handle for the bark shader name
+		/// The bark is opaque, so this shader has no alpha test and keeps early depth testing
+		//----------------------------------------------------------------------------------------------------------------------
+		static std::string s_barkShaderProgramName;
 		//----------------------------------------------------------------------------------------------------------------------
-		static std::string s_shaderProgramName;
+		/// @brief Handle for the leaf shader name
+		/// This is the only plant shader that discards transparent fragments
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief The cylinder mesh
+		static std::string s_leafShaderProgramName;
 		//----------------------------------------------------------------------------------------------------------------------
-		static std::unique_ptr<ngl::Obj> s_cylinder;
+		/// @brief Handle for the bark texture
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief Handle for the leaf geometry name
+		static GLuint s_barkTexture;
 		//----------------------------------------------------------------------------------------------------------------------
-		static std::string s_leafGeometryName;
+		/// @brief The leaf mesh
+		//----------------------------------------------------------------------------------------------------------------------
+		static std::unique_ptr<Mesh> s_leaf;
 		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Handle for the leaf geometry texture
 		//----------------------------------------------------------------------------------------------------------------------
@@ -259,10 +353,22 @@ class PlantBlueprint
 		//----------------------------------------------------------------------------------------------------------------------
 		std::string m_axiom;
 		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief L-system axiom encoded with the alphabet
+		//----------------------------------------------------------------------------------------------------------------------
+		ModuleString m_axiomModules;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The symbols of the axiom and production rules
+		//----------------------------------------------------------------------------------------------------------------------
+		Alphabet m_alphabet;
+		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Container for L-sytem production rules
 		//----------------------------------------------------------------------------------------------------------------------
 		std::vector<ProductionRule> m_productionRules;
 		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The production rules compiled into a trie, rebuilt whenever the rules are read
+		//----------------------------------------------------------------------------------------------------------------------
+		RuleTable m_ruleTable;
+		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief The max number of iterations for the L-system string expansion
 		//----------------------------------------------------------------------------------------------------------------------
 		unsigned m_maxDepth;
@@ -271,6 +377,10 @@ class PlantBlueprint
 		//----------------------------------------------------------------------------------------------------------------------
 		float m_drawAngle;
 		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The rotations of the turtle symbols by the draw angle, rebuilt whenever the angle is set
+		//----------------------------------------------------------------------------------------------------------------------
+		TurtleTable m_turtleTable;
+		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief The length of one forward draw command
 		//----------------------------------------------------------------------------------------------------------------------
 		float m_drawLength;
@@ -311,6 +421,11 @@ class PlantBlueprint
 		/// This is scaled by the size of the branches, so a branch of size 0.5 will have a gravitropism of 0.5 * gravitropismScaleFactor
 		//----------------------------------------------------------------------------------------------------------------------
 		float m_gravitropismScaleFactor;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Flag for whether new plants are derived straight to the max depth one module at a time
+		/// This is for deep plants whose L-system string wouldn't fit in memory. The plants don't grow step by step
+		//----------------------------------------------------------------------------------------------------------------------
+		bool m_streamDerivation = false;
 };
 
 #endif // PLANTBLUEPRINT_H_
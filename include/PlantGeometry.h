@@ -0,0 +1,118 @@
+#ifndef PLANTGEOMETRY_H_
+#define PLANTGEOMETRY_H_
+
+#include <cstddef>
+#include <vector>
+#include <ngl/Vec3.h>
+#include "Quaternion.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file PlantGeometry.h
+/// @brief This file contains the store of the nodes and leaves of every branch of a plant
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 23/05/17
+/// @class PointArray
+/// @brief This class stores 3D points as separate contiguous x, y and z arrays
+/// Loops over the points read each array linearly, so they can be vectorised
+//----------------------------------------------------------------------------------------------------------------------
+class PointArray
+{
+	public:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get the number of points
+		/// @return The number of points
+		//----------------------------------------------------------------------------------------------------------------------
+		std::size_t size() const {return m_x.size();}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Reserve space for points
+		/// @param _count The number of points
+		//----------------------------------------------------------------------------------------------------------------------
+		void reserve(std::size_t _count)
+		{
+			m_x.reserve(_count);
+			m_y.reserve(_count);
+			m_z.reserve(_count);
+		}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Remove all the points
+		//----------------------------------------------------------------------------------------------------------------------
+		void clear()
+		{
+			m_x.clear();
+			m_y.clear();
+			m_z.clear();
+		}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Add a point to the end
+		/// @param _point The point
+		//----------------------------------------------------------------------------------------------------------------------
+		void push_back(const ngl::Vec3& _point)
+		{
+			m_x.push_back(_point.m_x);
+			m_y.push_back(_point.m_y);
+			m_z.push_back(_point.m_z);
+		}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get a point
+		/// @param _index The index of the point
+		/// @return The point
+		//----------------------------------------------------------------------------------------------------------------------
+		ngl::Vec3 operator[](std::size_t _index) const {return ngl::Vec3(m_x[_index], m_y[_index], m_z[_index]);}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get the x coordinates
+		/// @return Pointer to the first x coordinate
+		//----------------------------------------------------------------------------------------------------------------------
+		const float* x() const {return m_x.data();}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get the y coordinates
+		/// @return Pointer to the first y coordinate
+		//----------------------------------------------------------------------------------------------------------------------
+		const float* y() const {return m_y.data();}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get the z coordinates
+		/// @return Pointer to the first z coordinate
+		//----------------------------------------------------------------------------------------------------------------------
+		const float* z() const {return m_z.data();}
+
+	private:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The x coordinates
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<float> m_x;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The y coordinates
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<float> m_y;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The z coordinates
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<float> m_z;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @struct PlantGeometry
+/// @brief Struct to contain the nodes and leaves of every branch of a plant
+/// Each branch is given a contiguous range of nodes and of leaves as it is evaluated, instead of owning its own vectors
+//----------------------------------------------------------------------------------------------------------------------
+typedef struct PlantGeometry
+{
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The positions of the branch nodes
+		//----------------------------------------------------------------------------------------------------------------------
+		PointArray m_nodes;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The turtle frame at each node, with the heading along the branch
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<Quaternion> m_nodeFrames;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The positions of the leaves
+		//----------------------------------------------------------------------------------------------------------------------
+		PointArray m_leafPositions;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The orientations of the leaves, taken from the frame of the node each leaf grows from
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<Quaternion> m_leafOrientations;
+} PlantGeometry;
+
+#endif // PLANTGEOMETRY_H_
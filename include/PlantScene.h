@@ -2,13 +2,14 @@
 #define PLANTSCENE_H_
 
 #include <array>
+#include <memory>
 #include <string>
 #include <vector>
 #include <ngl/Camera.h>
 #include <ngl/Mat4.h>
 #include <ngl/Vec3.h>
 #include <QOpenGLWidget>
-#include "Plant.h"
+#include "SceneRenderer.h"
 //----------------------------------------------------------------------------------------------------------------------
 /// @file PlantScene.h
 /// @brief This class is a widget in the MainWindow and draws the plants
@@ -67,6 +68,23 @@ class PlantScene : public QOpenGLWidget
 		/// @param _index The index into the vector m_plants
 		//----------------------------------------------------------------------------------------------------------------------
 		void deletePlant(unsigned _index);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Set function for the impostor distance
+		/// @param _distance The distance beyond which plants are drawn as impostors
+		//----------------------------------------------------------------------------------------------------------------------
+		void setImpostorDistance(float _distance) {m_renderer->setImpostorDistance(_distance); update();}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Show or hide the frame statistics overlay
+		/// While the overlay is shown the scene is redrawn continuously so the times stay current
+		/// @param _state The new overlay state
+		//----------------------------------------------------------------------------------------------------------------------
+		void setStatsOverlay(bool _state) {m_showStats = _state; update();}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Write the statistics of the frames drawn so far to a CSV file
+		/// @param _fileName The file to write
+		/// @return False if the file could not be written
+		//----------------------------------------------------------------------------------------------------------------------
+		bool exportStats(const std::string& _fileName) const {return m_renderer->stats().writeCSV(_fileName);}
 
 	private:
 		//----------------------------------------------------------------------------------------------------------------------
@@ -74,13 +92,10 @@ class PlantScene : public QOpenGLWidget
 		//----------------------------------------------------------------------------------------------------------------------
 		ngl::Camera m_camera;
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief Container of plant objects
-		//----------------------------------------------------------------------------------------------------------------------
-		std::vector<Plant> m_plants;
+		/// @brief The plants and everything needed to draw them
+		/// This is a pointer so it can be destroyed while the GL context is current
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief Ground Texture ID for draw calls
-		//----------------------------------------------------------------------------------------------------------------------
-		GLuint m_groundTexture;
+		std::unique_ptr<SceneRenderer> m_renderer;
 		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Last x position
 		//----------------------------------------------------------------------------------------------------------------------
@@ -93,17 +108,17 @@ class PlantScene : public QOpenGLWidget
 		/// @brief Mouse rotation flag
 		//----------------------------------------------------------------------------------------------------------------------
 		bool m_rotate = false;
-
-
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief Draw the ground plane and the plants in the scene
+		/// @brief Flag for whether to draw the frame statistics overlay
 		//----------------------------------------------------------------------------------------------------------------------
-		void drawScene();
+		bool m_showStats = false;
+
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief Initialise PlantBlueprint presets
-		/// These are hard coded values and the rules can be found in the folder presets
+		/// @brief Draw the frame statistics over the scene
 		//----------------------------------------------------------------------------------------------------------------------
-		void initialisePresets();
+		void drawStatsOverlay();
+
+
 		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Move the camera
 		/// @param _event Qt Key Event
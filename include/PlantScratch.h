@@ -0,0 +1,73 @@
+#ifndef PLANTSCRATCH_H_
+#define PLANTSCRATCH_H_
+
+#include <vector>
+#include <ngl/Vec3.h>
+#include "Branch.h"
+#include "ContextIndex.h"
+#include "ModuleString.h"
+#include "Quaternion.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file PlantScratch.h
+/// @brief This struct contains the temporary buffers used while updating a plant
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 23/05/17
+/// @struct PlantScratch
+/// @brief Struct to contain the temporary buffers of a plant update, so they are reused rather than allocated each update
+/// Resetting empties the buffers but keeps their memory, so once a plant has grown an update only allocates when a
+/// buffer needs more than it has ever held. The rewritten modules and the merged branches are swapped with the plant's,
+/// so the old ones become the next update's buffers
+//----------------------------------------------------------------------------------------------------------------------
+typedef struct PlantScratch
+{
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The modules written by a rewrite, which are swapped with the plant modules when it ends.
+		/// A streamed plant never rewrites, so this holds the branch being streamed instead
+		//----------------------------------------------------------------------------------------------------------------------
+		ModuleString m_modules;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The neighbours of the modules for context sensitive rules
+		//----------------------------------------------------------------------------------------------------------------------
+		ContextIndex m_context;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The parameters of the context sensitive rule being matched
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<float> m_contextParameters;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The index of each branch created by a rewrite in the final container
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<unsigned> m_newBranches;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The branches merged with the new ones, which are swapped with the plant branches
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<Branch> m_branches;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The start positions of the open branches while evaluating
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<ngl::Vec3> m_positionStack;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The start turtle frames of the open branches while evaluating
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<Quaternion> m_frameStack;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The creation depths of the open branches while streaming
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<unsigned> m_depthStack;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Empty every buffer, keeping the memory
+		//----------------------------------------------------------------------------------------------------------------------
+		void reset()
+		{
+			m_modules.clear();
+			m_contextParameters.clear();
+			m_newBranches.clear();
+			m_branches.clear();
+			m_positionStack.clear();
+			m_frameStack.clear();
+			m_depthStack.clear();
+		}
+} PlantScratch;
+
+#endif // PLANTSCRATCH_H_
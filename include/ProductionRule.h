@@ -15,19 +15,40 @@
 typedef struct ProductionRule
 {
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief The character(s) to be replaced
+		/// @brief The character(s) to be replaced, with the names of their parameters, e.g. A(t)
 		//----------------------------------------------------------------------------------------------------------------------
 		std::string m_predecessor;
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief The character(s) to replace
+		/// @brief The module(s) that must come before the predecessor, e.g. B(x) for B(x)<A. Empty if there is no left context
+		//----------------------------------------------------------------------------------------------------------------------
+		std::string m_leftContext;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The module(s) that must come after the predecessor, e.g. C for A>C. Empty if there is no right context
+		//----------------------------------------------------------------------------------------------------------------------
+		std::string m_rightContext;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The character(s) to replace, with expressions for their parameters, e.g. F(t*2)[+A(t-1)]
 		//----------------------------------------------------------------------------------------------------------------------
 		std::string m_successor;
 		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The condition on the context and predecessor parameters for the rule to apply, e.g. t>0. Empty if it always applies
+		//----------------------------------------------------------------------------------------------------------------------
+		std::string m_condition;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The weight of the successor among the rules with the same predecessor and condition
+		/// This is negative if the rule isn't stochastic
+		//----------------------------------------------------------------------------------------------------------------------
+		float m_probability;
+		//----------------------------------------------------------------------------------------------------------------------
 		/// @brief Constructor
 		//----------------------------------------------------------------------------------------------------------------------
-		ProductionRule(std::string _predecessor, std::string _successor) :
+		ProductionRule(std::string _predecessor, std::string _successor, std::string _condition = "", float _probability = -1.0f, std::string _leftContext = "", std::string _rightContext = "") :
 			m_predecessor(_predecessor),
-			m_successor(_successor){}
+			m_leftContext(_leftContext),
+			m_rightContext(_rightContext),
+			m_successor(_successor),
+			m_condition(_condition),
+			m_probability(_probability){}
 } ProductionRule;
 
 #endif // PRODUCTIONRULE_H_
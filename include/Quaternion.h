@@ -0,0 +1,159 @@
+#ifndef QUATERNION_H_
+#define QUATERNION_H_
+
+#include <cmath>
+#include <ngl/Util.h>
+#include <ngl/Vec3.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file Quaternion.h
+/// @brief A unit quaternion for the orientation of the turtle
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 23/05/17
+/// @class Quaternion
+/// @brief This class is a rotation stored as a unit quaternion, used as the full frame of the turtle
+/// The frame rotates the local axes onto the turtle axes. The heading is the local y axis, so the identity points up,
+/// the left is the local -x axis and the up is the local z axis. The frame keeps the roll of the turtle, which a
+/// direction vector alone can't, and rotating a vector needs no trigonometry
+//----------------------------------------------------------------------------------------------------------------------
+class Quaternion
+{
+	public:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor for the identity rotation
+		//----------------------------------------------------------------------------------------------------------------------
+		Quaternion() : m_s(1.0f), m_x(0.0f), m_y(0.0f), m_z(0.0f){}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor
+		/// @param _s The scalar part
+		/// @param _x The x component of the vector part
+		/// @param _y The y component of the vector part
+		/// @param _z The z component of the vector part
+		//----------------------------------------------------------------------------------------------------------------------
+		Quaternion(float _s, float _x, float _y, float _z) : m_s(_s), m_x(_x), m_y(_y), m_z(_z){}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Create a rotation around an axis
+		/// @param _axis The unit axis
+		/// @param _angle The angle in degrees, anticlockwise looking down the axis
+		/// @return The rotation
+		//----------------------------------------------------------------------------------------------------------------------
+		static Quaternion fromAxisAngle(const ngl::Vec3& _axis, float _angle)
+		{
+			float half = ngl::radians(_angle) / 2.0f;
+			float sinHalf = sin(half);
+			return Quaternion(cos(half), _axis.m_x * sinHalf, _axis.m_y * sinHalf, _axis.m_z * sinHalf);
+		}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Create the smallest rotation from one direction to another
+		/// This is found from the dot and cross product, without an angle, and only turns about the axis of the cross
+		/// product so it adds no roll
+		/// @param _from The unit direction to rotate from
+		/// @param _to The unit direction to rotate to
+		/// @return The rotation
+		//----------------------------------------------------------------------------------------------------------------------
+		static Quaternion between(const ngl::Vec3& _from, const ngl::Vec3& _to)
+		{
+			float d = _from.dot(_to);
+			//Opposite directions have no cross product, so turn half way round any perpendicular axis
+			if (d < -0.999999f)
+			{
+				ngl::Vec3 axis = _from.cross(fabs(_from.m_x) < 0.9f ? ngl::Vec3(1.0f, 0.0f, 0.0f) : ngl::Vec3(0.0f, 0.0f, 1.0f));
+				axis.normalize();
+				return Quaternion(0.0f, axis.m_x, axis.m_y, axis.m_z);
+			}
+			//Half the angle of (1 + d, cross) once normalised is the angle between the directions
+			ngl::Vec3 c = _from.cross(_to);
+			Quaternion result(1.0f + d, c.m_x, c.m_y, c.m_z);
+			result.normalize();
+			return result;
+		}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Combine two rotations
+		/// @param _rhs The rotation applied first, in the frame of this rotation
+		/// @return The combined rotation
+		//----------------------------------------------------------------------------------------------------------------------
+		Quaternion operator*(const Quaternion& _rhs) const
+		{
+			return Quaternion(m_s * _rhs.m_s - m_x * _rhs.m_x - m_y * _rhs.m_y - m_z * _rhs.m_z,
+												m_s * _rhs.m_x + m_x * _rhs.m_s + m_y * _rhs.m_z - m_z * _rhs.m_y,
+												m_s * _rhs.m_y - m_x * _rhs.m_z + m_y * _rhs.m_s + m_z * _rhs.m_x,
+												m_s * _rhs.m_z + m_x * _rhs.m_y - m_y * _rhs.m_x + m_z * _rhs.m_s);
+		}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Add two quaternions component-wise, for averaging rotations
+		/// @param _rhs The other quaternion
+		/// @return The sum, which needs normalising to be a rotation again
+		//----------------------------------------------------------------------------------------------------------------------
+		Quaternion operator+(const Quaternion& _rhs) const
+		{
+			return Quaternion(m_s + _rhs.m_s, m_x + _rhs.m_x, m_y + _rhs.m_y, m_z + _rhs.m_z);
+		}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Negate every component. The negated quaternion is the same rotation
+		/// @return The negated quaternion
+		//----------------------------------------------------------------------------------------------------------------------
+		Quaternion operator-() const
+		{
+			return Quaternion(-m_s, -m_x, -m_y, -m_z);
+		}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Four dimensional dot product, which is negative when two rotations lie on opposite sides of the sphere
+		/// @param _rhs The other quaternion
+		/// @return The dot product
+		//----------------------------------------------------------------------------------------------------------------------
+		float dot(const Quaternion& _rhs) const
+		{
+			return m_s * _rhs.m_s + m_x * _rhs.m_x + m_y * _rhs.m_y + m_z * _rhs.m_z;
+		}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Rotate a vector
+		/// @param _v The vector
+		/// @return The rotated vector
+		//----------------------------------------------------------------------------------------------------------------------
+		ngl::Vec3 rotate(const ngl::Vec3& _v) const
+		{
+			ngl::Vec3 u(m_x, m_y, m_z);
+			ngl::Vec3 t = u.cross(_v) * 2.0f;
+			return _v + t * m_s + u.cross(t);
+		}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get the heading of the frame
+		/// @return The local y axis rotated by this
+		//----------------------------------------------------------------------------------------------------------------------
+		ngl::Vec3 heading() const
+		{
+			return ngl::Vec3(2.0f * (m_x * m_y - m_s * m_z), 1.0f - 2.0f * (m_x * m_x + m_z * m_z), 2.0f * (m_y * m_z + m_s * m_x));
+		}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Scale back to unit length, to remove the error built up by combining rotations
+		//----------------------------------------------------------------------------------------------------------------------
+		void normalize()
+		{
+			float length = sqrt(m_s * m_s + m_x * m_x + m_y * m_y + m_z * m_z);
+			m_s /= length;
+			m_x /= length;
+			m_y /= length;
+			m_z /= length;
+		}
+
+	private:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The scalar part
+		//----------------------------------------------------------------------------------------------------------------------
+		float m_s;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The x component of the vector part
+		//----------------------------------------------------------------------------------------------------------------------
+		float m_x;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The y component of the vector part
+		//----------------------------------------------------------------------------------------------------------------------
+		float m_y;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The z component of the vector part
+		//----------------------------------------------------------------------------------------------------------------------
+		float m_z;
+};
+
+#endif // QUATERNION_H_
@@ -0,0 +1,288 @@
+#ifndef RULETABLE_H_
+#define RULETABLE_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "AliasTable.h"
+#include "Alphabet.h"
+#include "ContextIndex.h"
+#include "Expression.h"
+#include "ModuleString.h"
+#include "Philox.h"
+#include "ProductionRule.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file RuleTable.h
+/// @brief This class compiles the L-system production rules into a trie of their predecessors
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 23/05/17
+/// @class RuleTable
+/// @brief This class finds the rule to apply at a position in the modules without testing every rule
+/// Matching walks down the trie one symbol at a time, so it costs at most the length of the longest predecessor
+/// however many rules there are. Each node knows the first rule in file order ending at or below it, so the walk
+/// stops as soon as no longer predecessor could be applied instead of the best rule found so far.
+/// The conditions and successor parameters of parametric rules are compiled to Expressions when the table is built.
+/// Context sensitive rules are stored by their predecessor and check their contexts with a ContextIndex
+//----------------------------------------------------------------------------------------------------------------------
+class RuleTable
+{
+	public:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @struct Successor
+		/// @brief Struct to contain one successor of a production rule and the counts needed while rewriting
+		//----------------------------------------------------------------------------------------------------------------------
+		typedef struct Successor
+		{
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The module(s) to replace. The parameters are placeholders for the results of m_parameters
+				//----------------------------------------------------------------------------------------------------------------------
+				ModuleString m_modules;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The expression of each successor parameter in order, using the predecessor parameters
+				//----------------------------------------------------------------------------------------------------------------------
+				std::vector<Expression> m_parameters;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The number of branches started in the successor, i.e. the number of '['
+				//----------------------------------------------------------------------------------------------------------------------
+				unsigned m_branchCount;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The number of draw symbols in the successor, i.e. the number of 'F'
+				//----------------------------------------------------------------------------------------------------------------------
+				unsigned m_drawCount;
+		} Successor;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @struct Rule
+		/// @brief Struct to contain a compiled production rule
+		/// A stochastic rule has one successor for each line of the grammar with the same predecessor and condition
+		//----------------------------------------------------------------------------------------------------------------------
+		typedef struct Rule
+		{
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The module(s) to be replaced
+				//----------------------------------------------------------------------------------------------------------------------
+				ModuleString m_predecessor;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The module(s) that must come before the predecessor, in the order they are written
+				//----------------------------------------------------------------------------------------------------------------------
+				ModuleString m_leftContext;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The module(s) that must come after the predecessor, in the order they are written
+				//----------------------------------------------------------------------------------------------------------------------
+				ModuleString m_rightContext;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief Whether the rule has a left or right context
+				//----------------------------------------------------------------------------------------------------------------------
+				bool m_hasContext;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The number of parameters of the predecessor modules
+				//----------------------------------------------------------------------------------------------------------------------
+				unsigned m_predecessorParameterCount;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The condition for the rule to apply, using the context and predecessor parameters
+				//----------------------------------------------------------------------------------------------------------------------
+				Expression m_condition;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief Whether the rule has a condition, otherwise it always applies
+				//----------------------------------------------------------------------------------------------------------------------
+				bool m_hasCondition;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The successors. Deterministic rules have one
+				//----------------------------------------------------------------------------------------------------------------------
+				std::vector<Successor> m_successors;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The probabilities of the successors of a stochastic rule
+				//----------------------------------------------------------------------------------------------------------------------
+				AliasTable m_successorTable;
+		} Rule;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @struct Match
+		/// @brief Struct to contain the rule matched at a position and the parameters to apply it with
+		//----------------------------------------------------------------------------------------------------------------------
+		typedef struct Match
+		{
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The rule, or nullptr if none match and the module is copied unchanged
+				//----------------------------------------------------------------------------------------------------------------------
+				const Rule* m_rule;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The parameters of the left context, predecessor and right context, in the order they are named
+				//----------------------------------------------------------------------------------------------------------------------
+				const float* m_parameters;
+		} Match;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor for an empty table
+		//----------------------------------------------------------------------------------------------------------------------
+		RuleTable();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Rebuild the table from the production rules
+		/// Rules with an empty predecessor can never be applied, so they are ignored.
+		/// Rules that don't compile, or use a symbol with a different number of parameters than before, are skipped with a warning.
+		/// Rules with a probability are merged with the earlier rules with the same contexts, predecessor and condition
+		/// @param _rules The production rules, in the order they should be tested
+		/// @param _alphabet The alphabet to encode the rules with, which any new characters are added to
+		//----------------------------------------------------------------------------------------------------------------------
+		void build(const std::vector<ProductionRule>& _rules, Alphabet& _alphabet);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Find the first rule whose predecessor and contexts match the modules at a position and whose condition holds
+		/// @param _modules The modules to match in
+		/// @param _position The position to match at, which must be inside the modules
+		/// @param _firstParameter The index of the first parameter of the module at the position
+		/// @param _context The neighbours of the modules, or nullptr if there are no context sensitive rules
+		/// @param _contextParameters Storage for the parameters of a context sensitive rule, which aren't contiguous
+		/// @return The rule and its parameters
+		//----------------------------------------------------------------------------------------------------------------------
+		Match match(const ModuleString& _modules, std::size_t _position, std::size_t _firstParameter, const ContextIndex* _context, std::vector<float>& _contextParameters) const;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for whether any rule has a context, in which case matching needs a ContextIndex
+		/// @return True if there are context sensitive rules
+		//----------------------------------------------------------------------------------------------------------------------
+		bool hasContextRules() const {return m_hasContextRules;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for the number of modules in the longest predecessor
+		/// @return The length of the longest predecessor, or 0 if there are no rules
+		//----------------------------------------------------------------------------------------------------------------------
+		std::size_t longestPredecessor() const {return m_longestPredecessor;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Choose the successor of a rule
+		/// @param _rule The rule, from match
+		/// @param _random The generator for the choice of a stochastic rule. Deterministic rules don't use it
+		/// @return The successor
+		//----------------------------------------------------------------------------------------------------------------------
+		static const Successor& choose(const Rule& _rule, Philox& _random);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Add a successor, evaluating its parameters
+		/// @param _successor The successor, from choose
+		/// @param _parameters The parameters of the match
+		/// @param _modules The modules to add to
+		//----------------------------------------------------------------------------------------------------------------------
+		static void apply(const Successor& _successor, const float* _parameters, ModuleString& _modules);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Calculate an upper bound of the number of modules after one rewrite, so the output can be reserved
+		/// This is exact unless a symbol starts a rule with a predecessor longer than one symbol, a context, a condition or several successors
+		/// @param _modules The modules to be rewritten
+		/// @return The maximum number of rewritten modules
+		//----------------------------------------------------------------------------------------------------------------------
+		std::size_t rewrittenLength(const ModuleString& _modules) const;
+
+	private:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @struct Node
+		/// @brief Struct to contain a node of the trie, which is a prefix of one or more predecessors
+		//----------------------------------------------------------------------------------------------------------------------
+		typedef struct Node
+		{
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The index of the first rule whose predecessor ends at this node in m_nodeRules
+				//----------------------------------------------------------------------------------------------------------------------
+				unsigned m_firstNodeRule;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The number of rules whose predecessor ends at this node
+				//----------------------------------------------------------------------------------------------------------------------
+				unsigned m_nodeRuleCount;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The lowest index of the rules ending at this node or below it, or s_none
+				//----------------------------------------------------------------------------------------------------------------------
+				unsigned m_firstRule;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The index of the first edge to the children in m_edges
+				//----------------------------------------------------------------------------------------------------------------------
+				unsigned m_firstEdge;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The number of children
+				//----------------------------------------------------------------------------------------------------------------------
+				unsigned m_edgeCount;
+		} Node;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @struct Edge
+		/// @brief Struct to contain an edge from a node to a child
+		//----------------------------------------------------------------------------------------------------------------------
+		typedef struct Edge
+		{
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The symbol read to move to the child
+				//----------------------------------------------------------------------------------------------------------------------
+				uint8_t m_symbol;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The index of the child in m_nodes
+				//----------------------------------------------------------------------------------------------------------------------
+				unsigned m_node;
+		} Edge;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of symbol ids
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr std::size_t s_symbolCount = 256;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Index used for no rule or no node
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr unsigned s_none = std::numeric_limits<unsigned>::max();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The maximum number of modules in a context
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr std::size_t s_maxContextLength = 8;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The rules in file order
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<Rule> m_rules;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The rules ending at each node, stored contiguously per node in file order
+		/// A predecessor can have several rules with different conditions
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<unsigned> m_nodeRules;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The nodes of the trie. The root is node 0 and every child comes after its parent
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<Node> m_nodes;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The edges of every node, stored contiguously per node and sorted by symbol
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<Edge> m_edges;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The children of the root by symbol, or s_none. Every match starts here so it is a direct lookup
+		//----------------------------------------------------------------------------------------------------------------------
+		std::array<unsigned, s_symbolCount> m_rootNodes;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The maximum number of symbols written for each symbol read
+		//----------------------------------------------------------------------------------------------------------------------
+		std::array<std::size_t, s_symbolCount> m_expansion;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Whether any rule has a context
+		//----------------------------------------------------------------------------------------------------------------------
+		bool m_hasContextRules;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of modules in the longest predecessor
+		//----------------------------------------------------------------------------------------------------------------------
+		std::size_t m_longestPredecessor;
+
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Find the child of a node
+		/// @param _node The node
+		/// @param _symbol The symbol of the edge to the child
+		/// @return The index of the child, or s_none
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned child(const Node& _node, uint8_t _symbol) const;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Check the contexts of a rule whose predecessor matches, and gather its parameters
+		/// @param _rule The rule
+		/// @param _modules The modules to match in
+		/// @param _position The position of the first predecessor module
+		/// @param _end The position after the last predecessor module
+		/// @param _context The neighbours of the modules
+		/// @param _parameters Set to the parameters of the contexts and predecessor, in order
+		/// @return True if both contexts match
+		//----------------------------------------------------------------------------------------------------------------------
+		static bool matchContext(const Rule& _rule, const ModuleString& _modules, std::size_t _position, std::size_t _end, const ContextIndex& _context, std::vector<float>& _parameters);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Compile a production rule
+		/// @param _rule The production rule
+		/// @param _alphabet The alphabet to encode the rule with
+		/// @param _compiled The compiled rule, with one successor
+		/// @return False if the rule is invalid
+		//----------------------------------------------------------------------------------------------------------------------
+		static bool compile(const ProductionRule& _rule, Alphabet& _alphabet, Rule& _compiled);
+};
+
+#endif // RULETABLE_H_
@@ -0,0 +1,153 @@
+#ifndef SCENERENDERER_H_
+#define SCENERENDERER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <ngl/Camera.h>
+#include <ngl/Types.h>
+#include "FrameStats.h"
+#include "ImpostorAtlas.h"
+#include "Plant.h"
+#include "ThreadPool.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file SceneRenderer.h
+/// @brief This class owns the plants and draws the scene into a framebuffer
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 22/05/17
+/// @class SceneRenderer
+/// @brief This class contains everything needed to draw the scene, without depending on a window
+/// It is used by the PlantScene widget and by the HeadlessRenderer
+//----------------------------------------------------------------------------------------------------------------------
+class SceneRenderer
+{
+	public:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor. This does not need a GL context
+		//----------------------------------------------------------------------------------------------------------------------
+		SceneRenderer(){}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Destructor. The plants own GL buffers, so this must be called with a valid GL context
+		//----------------------------------------------------------------------------------------------------------------------
+		~SceneRenderer(){}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Delete copy constructor since this owns GL objects
+		//----------------------------------------------------------------------------------------------------------------------
+		SceneRenderer(const SceneRenderer&) = delete;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Delete copy assignment since this owns GL objects
+		//----------------------------------------------------------------------------------------------------------------------
+		SceneRenderer& operator=(const SceneRenderer&) = delete;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Initialise PlantBlueprint presets
+		/// These are hard coded values and the rules can be found in the folder presets
+		//----------------------------------------------------------------------------------------------------------------------
+		static void initialisePresets();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Initialise the GL state, shaders and geometry
+		/// Note this can only be performed after a valid GL context has been created
+		//----------------------------------------------------------------------------------------------------------------------
+		void initGL();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Clear the framebuffer and draw the ground plane and the plants
+		/// @param _camera The camera to draw from
+		/// @param _framebuffer The framebuffer being drawn to, which is rebound after capturing impostors
+		/// @param _width The width of the framebuffer
+		/// @param _height The height of the framebuffer
+		//----------------------------------------------------------------------------------------------------------------------
+		void render(const ngl::Camera& _camera, GLuint _framebuffer, int _width, int _height);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Update all the plant simulations, spread across the thread pool
+		//----------------------------------------------------------------------------------------------------------------------
+		void updatePlants();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Create a new plant object in the container
+		/// @param _type The PlantBlueprint for the object to use
+		/// @param _x The x coordinate to place the object at
+		/// @param _z The z coordinate to place the object at
+		//----------------------------------------------------------------------------------------------------------------------
+		void createPlant(const std::string& _type, float _x, float _z);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Set a plant visibility from the container
+		/// @param _index The index into the vector m_plants
+		/// @param _state The new visibility state
+		//----------------------------------------------------------------------------------------------------------------------
+		void setPlantVisibility(unsigned _index, bool _state);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Delete a plant from the container
+		/// The plant owns GL buffers, so this must be called with a valid GL context
+		/// @param _index The index into the vector m_plants
+		//----------------------------------------------------------------------------------------------------------------------
+		void deletePlant(unsigned _index);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Set function for the impostor distance
+		/// @param _distance The distance beyond which plants are drawn as impostors
+		//----------------------------------------------------------------------------------------------------------------------
+		void setImpostorDistance(float _distance) {m_impostorDistance = _distance;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for the plants
+		/// @return Reference to the container of plants
+		//----------------------------------------------------------------------------------------------------------------------
+		const std::vector<Plant>& plants() const {return m_plants;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for the frame statistics
+		/// @return Reference to the statistics of the frames rendered
+		//----------------------------------------------------------------------------------------------------------------------
+		FrameStats& stats() {return m_stats;}
+
+	private:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Container of plant objects
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<Plant> m_plants;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The plants drawn with geometry this frame
+		/// This is a member so the memory is reused between frames
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<const Plant*> m_visiblePlants;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Threads used to update the plants
+		//----------------------------------------------------------------------------------------------------------------------
+		ThreadPool m_threadPool;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Captured views of distant plants
+		/// This is created in initGL as it needs a GL context
+		//----------------------------------------------------------------------------------------------------------------------
+		std::unique_ptr<ImpostorAtlas> m_impostors;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The distance beyond which plants are drawn as impostors
+		//----------------------------------------------------------------------------------------------------------------------
+		float m_impostorDistance = 45.0f;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The maximum number of impostors captured per frame, to avoid a stall when many plants move out of range
+		/// Plants waiting to be captured are drawn normally
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr unsigned s_impostorCapturesPerFrame = 4;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Handle for the ground shader name
+		//----------------------------------------------------------------------------------------------------------------------
+		static const std::string s_groundShaderProgramName;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Ground Texture ID for draw calls
+		//----------------------------------------------------------------------------------------------------------------------
+		GLuint m_groundTexture = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Time and draw counts of each frame
+		//----------------------------------------------------------------------------------------------------------------------
+		FrameStats m_stats;
+
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Set the GL state needed for drawing the scene
+		//----------------------------------------------------------------------------------------------------------------------
+		void setGLState();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Cull the plants, capture impostors, then draw the ground plane, the plants and the impostors
+		/// @param _camera The camera to draw from
+		/// @param _framebuffer The framebuffer being drawn to
+		//----------------------------------------------------------------------------------------------------------------------
+		void drawScene(const ngl::Camera& _camera, GLuint _framebuffer);
+};
+
+#endif // SCENERENDERER_H_
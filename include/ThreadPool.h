@@ -0,0 +1,139 @@
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file ThreadPool.h
+/// @brief This class runs independent pieces of work across a fixed set of threads
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 23/05/17
+/// @class ThreadPool
+/// @brief This class is a work stealing thread pool for parallel loops
+/// Each thread starts with an even share of the loop. A thread that runs out of work steals half of the remaining work
+/// of another thread, so plants that take longer to grow don't leave the other threads idle
+//----------------------------------------------------------------------------------------------------------------------
+class ThreadPool
+{
+	public:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor. This starts the threads
+		/// @param _threadCount The number of threads including the calling thread. 0 uses one per hardware thread
+		//----------------------------------------------------------------------------------------------------------------------
+		explicit ThreadPool(unsigned _threadCount = 0);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Destructor. This stops and joins the threads
+		//----------------------------------------------------------------------------------------------------------------------
+		~ThreadPool();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Delete copy constructor since this owns threads
+		//----------------------------------------------------------------------------------------------------------------------
+		ThreadPool(const ThreadPool&) = delete;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Delete copy assignment since this owns threads
+		//----------------------------------------------------------------------------------------------------------------------
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Call a function for every index in [0, _count) and wait for them all to finish
+		/// The calling thread does a share of the work. The calls must be independent of each other
+		/// @param _count The number of indices
+		/// @param _function The function to call with each index
+		//----------------------------------------------------------------------------------------------------------------------
+		void parallelFor(unsigned _count, const std::function<void(unsigned)>& _function);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get function for the number of threads, including the calling thread
+		/// @return The number of threads
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned threadCount() const {return static_cast<unsigned>(m_threads.size()) + 1;}
+
+	private:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @struct WorkRange
+		/// @brief Struct to contain the indices a thread has left to do
+		//----------------------------------------------------------------------------------------------------------------------
+		typedef struct WorkRange
+		{
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief Guards the range, as other threads steal from the end of it
+				//----------------------------------------------------------------------------------------------------------------------
+				std::mutex m_mutex;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief The next index to do
+				//----------------------------------------------------------------------------------------------------------------------
+				unsigned m_begin = 0;
+				//----------------------------------------------------------------------------------------------------------------------
+				/// @brief One past the last index to do
+				//----------------------------------------------------------------------------------------------------------------------
+				unsigned m_end = 0;
+		} WorkRange;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The worker threads. The calling thread is worker 0 and is not in here
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<std::thread> m_threads;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The work left for each worker
+		/// These are pointers as mutexes can't be moved
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<std::unique_ptr<WorkRange>> m_ranges;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Guards the job state below
+		//----------------------------------------------------------------------------------------------------------------------
+		std::mutex m_mutex;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Wakes the threads when there is a new job or the pool is stopping
+		//----------------------------------------------------------------------------------------------------------------------
+		std::condition_variable m_wake;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Wakes the calling thread when the last worker finishes
+		//----------------------------------------------------------------------------------------------------------------------
+		std::condition_variable m_done;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The function of the current job
+		//----------------------------------------------------------------------------------------------------------------------
+		const std::function<void(unsigned)>* m_function = nullptr;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Incremented for every job, so the threads know when a new one has started
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_job = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of threads still working on the current job
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_busyThreads = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Flag to stop the threads
+		//----------------------------------------------------------------------------------------------------------------------
+		bool m_isStopping = false;
+
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The loop of each worker thread, waiting for jobs
+		/// @param _worker The index of the worker
+		//----------------------------------------------------------------------------------------------------------------------
+		void workerLoop(unsigned _worker);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Do the work of the current job until there is none left to do or steal
+		/// @param _worker The index of the worker
+		//----------------------------------------------------------------------------------------------------------------------
+		void work(unsigned _worker);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Take the next index from a worker's own range
+		/// @param _worker The index of the worker
+		/// @param _index The index taken
+		/// @return False if the range is empty
+		//----------------------------------------------------------------------------------------------------------------------
+		bool pop(unsigned _worker, unsigned& _index);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Take the second half of another worker's range, keeping the rest for later
+		/// @param _worker The index of the worker stealing
+		/// @param _index The first index stolen
+		/// @return False if every range is empty
+		//----------------------------------------------------------------------------------------------------------------------
+		bool steal(unsigned _worker, unsigned& _index);
+};
+
+#endif // THREADPOOL_H_
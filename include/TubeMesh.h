@@ -0,0 +1,122 @@
+#ifndef TUBEMESH_H_
+#define TUBEMESH_H_
+
+#include <cstddef>
+#include <vector>
+#include <ngl/Vec3.h>
+#include "Mesh.h"
+
+class PointArray;
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file TubeMesh.h
+/// @brief This class generates one continuous mesh for all the branches of a plant
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 18/05/17
+/// @class TubeMesh
+/// @brief This class sweeps a ring along the nodes of each branch to create a generalised cylinder
+/// Branches are appended as they are created, and only the new geometry is uploaded to the GPU
+//----------------------------------------------------------------------------------------------------------------------
+class TubeMesh
+{
+	public:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Constructor
+		/// @param _radialSegments The number of vertices around each ring
+		//----------------------------------------------------------------------------------------------------------------------
+		TubeMesh(unsigned _radialSegments);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Add the geometry of a branch to the mesh
+		/// The nodes are read straight from the coordinate arrays, so no copy of the branch is needed
+		/// @param _nodes The positions of the nodes of every branch
+		/// @param _first The index of the first node of the branch
+		/// @param _count The number of nodes of the branch
+		/// @param _stride Sweep every nth node, always keeping both ends. 1 sweeps every node and 0 only the ends
+		/// @param _radius The radius of the branch
+		//----------------------------------------------------------------------------------------------------------------------
+		void addBranch(const PointArray& _nodes, unsigned _first, unsigned _count, unsigned _stride, float _radius);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get the number of nodes addBranch sweeps
+		/// @param _count The number of nodes of the branch
+		/// @param _stride The node stride given to addBranch
+		/// @return The number of nodes swept, or 0 if the branch is too short to sweep
+		//----------------------------------------------------------------------------------------------------------------------
+		static unsigned sweptNodeCount(unsigned _count, unsigned _stride);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Allocate room for more branches at once, so adding them one at a time doesn't reallocate
+		/// addBranch doesn't reserve itself, as reserving each branch exactly would copy the whole mesh every time
+		/// @param _nodeCount The total number of nodes of the branches
+		/// @param _branchCount The number of branches
+		//----------------------------------------------------------------------------------------------------------------------
+		void reserve(std::size_t _nodeCount, std::size_t _branchCount);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Remove all the branches
+		/// The GPU buffers are kept, so rebuilding a mesh of a similar size does not reallocate
+		//----------------------------------------------------------------------------------------------------------------------
+		void clear();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Upload the geometry added since the last upload
+		/// This needs a valid GL context
+		//----------------------------------------------------------------------------------------------------------------------
+		void upload();
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Draw all the branches with one draw call
+		//----------------------------------------------------------------------------------------------------------------------
+		void draw() const;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Draw some of the branches with one draw call
+		/// @param _counts The number of indices in each range
+		/// @param _offsets The byte offset of the first index of each range
+		//----------------------------------------------------------------------------------------------------------------------
+		void drawRanges(const std::vector<GLsizei>& _counts, const std::vector<const GLvoid*>& _offsets) const;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get the number of indices added so far
+		/// This is used to find the index range of each branch
+		/// @return The number of indices
+		//----------------------------------------------------------------------------------------------------------------------
+		std::size_t indexCount() const {return m_indices.size();}
+
+	private:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of vertices around each ring
+		//----------------------------------------------------------------------------------------------------------------------
+		unsigned m_radialSegments;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Precomputed cosines of the ring angles, so no trigonometry is needed per ring
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<float> m_cosTable;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Precomputed sines of the ring angles, so no trigonometry is needed per ring
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<float> m_sinTable;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The vertices of all the branches
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<Vertex> m_vertices;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The indices of all the branches
+		//----------------------------------------------------------------------------------------------------------------------
+		std::vector<GLuint> m_indices;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of vertices already on the GPU
+		//----------------------------------------------------------------------------------------------------------------------
+		std::size_t m_uploadedVertices = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of indices already on the GPU
+		//----------------------------------------------------------------------------------------------------------------------
+		std::size_t m_uploadedIndices = 0;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The GPU buffers
+		//----------------------------------------------------------------------------------------------------------------------
+		Mesh m_mesh;
+
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Calculate a unit vector perpendicular to a direction
+		/// @param _direction The normalised direction
+		/// @return A normalised perpendicular vector
+		//----------------------------------------------------------------------------------------------------------------------
+		static ngl::Vec3 perpendicular(const ngl::Vec3& _direction);
+};
+
+#endif // TUBEMESH_H_
@@ -0,0 +1,61 @@
+#ifndef TURTLETABLE_H_
+#define TURTLETABLE_H_
+
+#include <array>
+#include <cstdint>
+#include "Alphabet.h"
+#include "Quaternion.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+/// @file TurtleTable.h
+/// @brief This class stores the rotations of the turtle symbols for a blueprint
+/// @author Neerav Nagda
+/// @version 1.0
+/// @date 23/05/17
+/// @class TurtleTable
+/// @brief This class precomputes the rotation of each turtle rotation symbol for the blueprint draw angle
+/// The draw angle only changes when the blueprint is edited, so the sines and cosines are found once then rather than
+/// for every symbol interpreted. Only rotations with their own angle parameter need a new quaternion.
+/// The rotations are about the axes of the turtle frame, so they are applied after the frame. The rotation symbols are
+/// consecutive in the alphabet, from ROLL_RIGHT to PITCH_UP, so the table is indexed by the symbol
+//----------------------------------------------------------------------------------------------------------------------
+class TurtleTable
+{
+	public:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Compute the rotations for an angle, replacing the current ones
+		/// @param _angle The draw angle in degrees
+		//----------------------------------------------------------------------------------------------------------------------
+		void build(float _angle);
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Find if a symbol rotates the turtle
+		/// @param _symbol The symbol
+		/// @return True if the symbol is one of the rotations
+		//----------------------------------------------------------------------------------------------------------------------
+		static bool isRotation(uint8_t _symbol) {return _symbol >= Alphabet::ROLL_RIGHT && _symbol <= Alphabet::PITCH_UP;}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Get the rotation of a symbol by the draw angle
+		/// @param _symbol The symbol, which must be a rotation
+		/// @return Reference to the rotation about the turtle axes
+		//----------------------------------------------------------------------------------------------------------------------
+		const Quaternion& rotation(uint8_t _symbol) const {return m_rotations[_symbol - Alphabet::ROLL_RIGHT];}
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief Compute the rotation of a symbol by any angle, for symbols with an angle parameter
+		/// @param _symbol The symbol, which must be a rotation
+		/// @param _angle The angle in degrees
+		/// @return The rotation about the turtle axes
+		//----------------------------------------------------------------------------------------------------------------------
+		static Quaternion rotation(uint8_t _symbol, float _angle);
+
+	private:
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The number of rotation symbols
+		//----------------------------------------------------------------------------------------------------------------------
+		static constexpr unsigned s_rotationCount = Alphabet::PITCH_UP - Alphabet::ROLL_RIGHT + 1;
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief The rotation of each symbol by the draw angle, in the order of the symbols
+		//----------------------------------------------------------------------------------------------------------------------
+		std::array<Quaternion, s_rotationCount> m_rotations;
+};
+
+#endif // TURTLETABLE_H_
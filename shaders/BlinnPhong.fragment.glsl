@@ -83,10 +83,7 @@ vec3 calculateLightContribution()
 //----------------------------------------------------------------------------------------------------------------------
 void main(void)
 {
-	if (diffuseColour.w == 0.0f)//Discard fragments with zero alpha
-	{
-		discard;
-	}
+	//The bark and ground are opaque. There is no discard here so early depth testing stays enabled
 	vec3 totalColour = calculateLightContribution();
 
 	fragColour = vec4(totalColour,1.0f);
@@ -0,0 +1,21 @@
+#version 330 core
+/// @brief the output colour
+layout (location = 0) out vec4 fragColour;
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief the UV coordinates and atlas layer
+in vec3 uvCoord;
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief the captured views, with one layer per plant
+//----------------------------------------------------------------------------------------------------------------------
+uniform sampler2DArray impostorAtlas;
+//----------------------------------------------------------------------------------------------------------------------
+void main(void)
+{
+	//The lighting was baked when the views were captured
+	vec4 colour = texture(impostorAtlas, uvCoord);
+	if (colour.a < 0.5f)//Discard the background around the plant
+	{
+		discard;
+	}
+	fragColour = vec4(colour.rgb, 1.0f);
+}
@@ -0,0 +1,42 @@
+#version 330 core
+/// @brief The UV passed in, used as the corner of the quad
+layout (location = 1) in vec2 inUV;
+/// @brief The centre of the impostor
+layout (location = 3) in vec3 inCentre;
+/// @brief The half size of the impostor
+layout (location = 4) in float inRadius;
+/// @brief The atlas layer of the impostor
+layout (location = 5) in float inLayer;
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief the camera position
+uniform vec3 viewerPos;
+/// @brief view * projection matrix
+uniform mat4 VP;
+/// @brief the number of views captured around each plant
+uniform int viewCount = 8;
+/// @brief the number of columns of views in each layer
+uniform int atlasColumns = 4;
+/// @brief the number of rows of views in each layer
+uniform int atlasRows = 2;
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief the UV coordinates and atlas layer
+out vec3 uvCoord;
+//----------------------------------------------------------------------------------------------------------------------
+void main(void)
+{
+	//Find the angle of the camera around the y axis of the impostor
+	vec3 toViewer = viewerPos - inCentre;
+	float angle = atan(toViewer.z, toViewer.x);
+
+	//Turn the quad about the y axis to face the camera. This matches the right vector of the captured views
+	vec3 right = vec3(sin(angle), 0.0f, -cos(angle));
+	vec2 corner = inUV * 2.0f - 1.0f;
+	vec3 worldPosition = inCentre + (right * corner.x + vec3(0.0f, 1.0f, 0.0f) * corner.y) * inRadius;
+	gl_Position = VP * vec4(worldPosition, 1.0f);
+
+	//Choose the captured view closest to the camera angle
+	int view = int(round(angle * float(viewCount) / 6.28318530718f));
+	view = (view % viewCount + viewCount) % viewCount;
+	vec2 tile = vec2(view % atlasColumns, view / atlasColumns);
+	uvCoord = vec3((tile + inUV) / vec2(atlasColumns, atlasRows), inLayer);
+}
@@ -0,0 +1,72 @@
+#version 330 core
+/// @brief The vertex passed in
+layout (location = 0) in vec3 inVert;
+/// @brief The UV passed in
+layout (location = 1) in vec2 inUV;
+/// @brief The normal passed in
+layout (location = 2) in vec3 inNormal;
+/// @brief The position of the leaf instance
+layout (location = 3) in vec3 inLeafPosition;
+/// @brief The rotation of the leaf instance, as a unit quaternion with the scalar part first
+layout (location = 4) in vec4 inLeafOrientation;
+/// @brief The scale of the leaf instance
+layout (location = 5) in float inLeafScale;
+//----------------------------------------------------------------------------------------------------------------------
+uniform 	vec3 viewerPos;
+/// @brief view matrix
+uniform mat4 V;
+/// @brief view * projection matrix
+uniform mat4 VP;
+/// @brief the sun position
+uniform vec3 sunPosition = vec3(0.0f, 100.0f, 0.0f);
+/// @brief the texture tile factor
+uniform float texScale = 1.0f;
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief the UV coordinates
+out vec2 uvCoord;
+/// @brief fragment position
+out vec3 fragPos;
+/// @brief fragment normal
+out vec3 fragNormal;
+/// @brief eye direction
+out vec3 eyeDirection;
+/// @brief sunlight direction
+out vec3 sunDirection;
+/// @brief half vector
+out vec3 halfVector;
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief rotate a vector by a unit quaternion
+/// @param _q The quaternion, with the scalar part first
+/// @param _v The vector to rotate
+//----------------------------------------------------------------------------------------------------------------------
+vec3 rotateByQuaternion(vec4 _q, vec3 _v)
+{
+	vec3 t = 2.0f * cross(_q.yzw, _v);
+	return _v + _q.x * t + cross(_q.yzw, t);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void main(void)
+{
+	//Scale the UV coordinates if the object needs to tile the texture
+	uvCoord = inUV * texScale;
+
+	//Calculate the world position of the vertex
+	vec4 worldPosition = vec4(rotateByQuaternion(inLeafOrientation, inVert * inLeafScale) + inLeafPosition, 1.0f);
+
+	//Calculate the eye direction
+	eyeDirection = normalize(viewerPos - worldPosition.xyz);
+
+	//Calculate the vertex position
+	gl_Position = VP * worldPosition;
+
+	//Calculate the fragment position
+	vec4 eyePos = V * worldPosition;
+	fragPos = eyePos.xyz / eyePos.w;
+
+	//Calculate the fragment normal. The leaf is scaled uniformly so no inverse is needed
+	fragNormal = normalize(mat3(V) * rotateByQuaternion(inLeafOrientation, inNormal));
+
+	//Calculate half-vector and sunlight direction
+	sunDirection = normalize(vec3(sunPosition - eyePos.xyz));
+	halfVector = normalize(eyeDirection + sunDirection);
+}
@@ -0,0 +1,43 @@
+#include "AliasTable.h"
+//----------------------------------------------------------------------------------------------------------------------
+void AliasTable::build(const std::vector<float>& _weights)
+{
+	std::size_t count = _weights.size();
+	m_probabilities.assign(count, 1.0f);
+	m_aliases.resize(count);
+	for (unsigned i=0; i<count; ++i) m_aliases[i] = i;
+
+	float sum = 0.0f;
+	for (float w : _weights) sum += w;
+	//Leave every outcome equally likely
+	if (sum <= 0.0f) return;
+
+	//Scale the weights so the average is 1, and split them into the columns below and above the average
+	std::vector<float> scaled(count);
+	std::vector<unsigned> small;
+	std::vector<unsigned> large;
+	for (unsigned i=0; i<count; ++i)
+	{
+		scaled[i] = _weights[i] * count / sum;
+		if (scaled[i] < 1.0f) small.push_back(i);
+		else large.push_back(i);
+	}
+
+	//Fill each small column up to 1 with part of a large column
+	while (!small.empty() && !large.empty())
+	{
+		unsigned s = small.back();
+		small.pop_back();
+		unsigned l = large.back();
+		large.pop_back();
+
+		m_probabilities[s] = scaled[s];
+		m_aliases[s] = l;
+
+		scaled[l] = (scaled[l] + scaled[s]) - 1.0f;
+		if (scaled[l] < 1.0f) small.push_back(l);
+		else large.push_back(l);
+	}
+	//Whatever is left is 1 up to rounding error, so always kept
+}
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,114 @@
+#include "Alphabet.h"
+#include "Expression.h"
+//----------------------------------------------------------------------------------------------------------------------
+constexpr unsigned Alphabet::s_unassigned;
+//----------------------------------------------------------------------------------------------------------------------
+Alphabet::Alphabet()
+{
+	m_symbols.fill(s_unassigned);
+	//Add the turtle symbols in the order of the SYMBOL enum
+	for (char c : std::string("[]F/\\+-&^"))
+	{
+		symbol(c);
+	}
+	//Brackets never have parameters
+	useArity(PUSH, 0);
+	useArity(POP, 0);
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint8_t Alphabet::symbol(char _character)
+{
+	unsigned& id = m_symbols[static_cast<unsigned char>(_character)];
+	//A char has 256 values, so there are always enough 8 bit ids
+	if (id == s_unassigned)
+	{
+		id = static_cast<unsigned>(m_characters.size());
+		m_characters.push_back(_character);
+		m_arities.push_back(0);
+		m_isArityKnown.push_back(false);
+		m_isIgnored.push_back(false);
+	}
+	return static_cast<uint8_t>(id);
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool Alphabet::useArity(uint8_t _symbol, unsigned _arity)
+{
+	if (!m_isArityKnown[_symbol])
+	{
+		//The arity is stored in 8 bits
+		if (_arity > 255) return false;
+		m_arities[_symbol] = static_cast<uint8_t>(_arity);
+		m_isArityKnown[_symbol] = true;
+	}
+	return m_arities[_symbol] == _arity;
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool Alphabet::split(const std::string& _string, std::vector<ModuleText>& _modules)
+{
+	_modules.clear();
+	for (std::size_t i=0; i<_string.length(); ++i)
+	{
+		char c = _string[i];
+		if (c == '(' || c == ')' || c == ',') return false;
+		_modules.push_back({c, {}});
+		if (i+1 == _string.length() || _string[i+1] != '(') continue;
+
+		//Read the arguments up to the matching bracket, splitting on the commas outside any nested brackets
+		std::vector<std::string>& arguments = _modules.back().m_arguments;
+		unsigned depth = 0;
+		std::size_t argumentStart = i+2;
+		for (i=i+1; i<_string.length(); ++i)
+		{
+			char a = _string[i];
+			if (a == '(') ++depth;
+			else if (a == ')') --depth;
+			if ((a == ',' && depth == 1) || (a == ')' && depth == 0))
+			{
+				if (i == argumentStart) return false;
+				arguments.push_back(_string.substr(argumentStart, i - argumentStart));
+				argumentStart = i+1;
+			}
+			if (depth == 0) break;
+		}
+		if (depth != 0) return false;
+	}
+	return true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool Alphabet::encode(const std::string& _string, ModuleString& _modules)
+{
+	std::vector<ModuleText> modules;
+	if (!split(_string, modules)) return false;
+
+	_modules.clear();
+	_modules.reserve(modules.size());
+	const std::vector<std::string> noParameters;
+	std::vector<float> values;
+	for (const ModuleText& m : modules)
+	{
+		uint8_t id = symbol(m.m_character);
+		if (!useArity(id, static_cast<unsigned>(m.m_arguments.size()))) return false;
+
+		values.clear();
+		for (const std::string& a : m.m_arguments)
+		{
+			Expression argument;
+			if (!argument.compile(a, noParameters)) return false;
+			values.push_back(argument.evaluate(nullptr));
+		}
+		_modules.append(id, values.data(), values.size());
+	}
+	return true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+std::string Alphabet::decode(const ModuleString& _modules) const
+{
+	std::string string;
+	string.reserve(_modules.size());
+	for (uint8_t s : _modules.symbols())
+	{
+		string += character(s);
+	}
+	return string;
+}
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,74 @@
+#include "ContextIndex.h"
+//----------------------------------------------------------------------------------------------------------------------
+constexpr uint32_t ContextIndex::s_none;
+//----------------------------------------------------------------------------------------------------------------------
+void ContextIndex::build(const ModuleString& _modules, const Alphabet& _alphabet)
+{
+	uint32_t count = static_cast<uint32_t>(_modules.size());
+	m_left.resize(count);
+	m_right.resize(count);
+	m_firstParameters.resize(count + 1);
+
+	//Find where the parameters of each module start
+	uint32_t parameter = 0;
+	for (uint32_t i=0; i<count; ++i)
+	{
+		m_firstParameters[i] = parameter;
+		parameter += _alphabet.arity(_modules[i]);
+	}
+	m_firstParameters[count] = parameter;
+
+	//Left to right. A branch starts with the neighbour before it and goes back to that neighbour when it ends
+	m_stack.clear();
+	uint32_t last = s_none;
+	for (uint32_t i=0; i<count; ++i)
+	{
+		uint8_t symbol = _modules[i];
+		m_left[i] = s_none;
+		if (symbol == Alphabet::PUSH)
+		{
+			m_stack.push_back(last);
+		}
+		else if (symbol == Alphabet::POP)
+		{
+			if (!m_stack.empty())
+			{
+				last = m_stack.back();
+				m_stack.pop_back();
+			}
+		}
+		else
+		{
+			m_left[i] = last;
+			if (!_alphabet.isIgnored(symbol)) last = i;
+		}
+	}
+
+	//Right to left. A branch is skipped by restoring the neighbour from after it once its start is reached
+	m_stack.clear();
+	uint32_t next = s_none;
+	for (uint32_t i=count; i-- > 0;)
+	{
+		uint8_t symbol = _modules[i];
+		m_right[i] = s_none;
+		if (symbol == Alphabet::POP)
+		{
+			m_stack.push_back(next);
+			next = s_none;
+		}
+		else if (symbol == Alphabet::PUSH)
+		{
+			if (!m_stack.empty())
+			{
+				next = m_stack.back();
+				m_stack.pop_back();
+			}
+		}
+		else
+		{
+			m_right[i] = next;
+			if (!_alphabet.isIgnored(symbol)) next = i;
+		}
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,103 @@
+#include "Derivation.h"
+#include "Philox.h"
+//----------------------------------------------------------------------------------------------------------------------
+Derivation::Derivation(const RuleTable& _rules, const Alphabet& _alphabet, uint32_t _seed) :
+	m_rules(&_rules),
+	m_alphabet(&_alphabet),
+	m_seed(_seed),
+	m_level(0),
+	m_isReplaced(false)
+{}
+//----------------------------------------------------------------------------------------------------------------------
+bool Derivation::canStream(const RuleTable& _rules)
+{
+	return !_rules.hasContextRules() && _rules.longestPredecessor() <= 1;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void Derivation::start(const ModuleString& _axiom, unsigned _depth)
+{
+	m_frames.resize(_depth + 1);
+	m_positions.assign(_depth + 1, 0);
+	m_frames[0] = {_axiom, 0, 0, 0};
+	m_level = 0;
+	m_isReplaced = false;
+}
+//----------------------------------------------------------------------------------------------------------------------
+std::vector<unsigned> Derivation::levelDepths(const RuleTable& _rules, const Alphabet& _alphabet, uint32_t _seed, const ModuleString& _axiom, unsigned _depth)
+{
+	std::vector<unsigned> depths(1, 0);
+	Derivation derivation(_rules, _alphabet, _seed);
+	Module module;
+	unsigned fCount = _axiom.count(Alphabet::DRAW);
+	for (unsigned depth=1; depth<=_depth; ++depth)
+	{
+		//Like Plant::stringRewrite, rewrite again while the number of F is the same and a rule applied
+		bool isRerun = true;
+		while (isRerun)
+		{
+			derivation.start(_axiom, static_cast<unsigned>(depths.size()));
+			unsigned newFCount = 0;
+			while (derivation.next(module))
+			{
+				if (module.m_symbol == Alphabet::DRAW) ++newFCount;
+			}
+			depths.push_back(depth);
+			isRerun = newFCount == fCount && derivation.isReplaced();
+			fCount = newFCount;
+		}
+	}
+	return depths;
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool Derivation::next(Module& _module)
+{
+	unsigned lastLevel = static_cast<unsigned>(m_frames.size()) - 1;
+	while (true)
+	{
+		//Go back up a level once its modules have all been expanded
+		Frame& frame = m_frames[m_level];
+		if (frame.m_position == frame.m_modules.size())
+		{
+			if (m_level == 0) return false;
+			--m_level;
+			continue;
+		}
+
+		uint8_t symbol = frame.m_modules[frame.m_position];
+		unsigned arity = m_alphabet->arity(symbol);
+		const float* parameters = frame.m_modules.parameters().data() + frame.m_parameter;
+		uint32_t index = m_positions[m_level]++;
+
+		//Modules at the last level are the derived string
+		if (m_level == lastLevel)
+		{
+			++frame.m_position;
+			frame.m_parameter += arity;
+			_module = {symbol, parameters, frame.m_depth};
+			return true;
+		}
+
+		//Otherwise rewrite the module into the level below, which is expanded next
+		Frame& child = m_frames[m_level + 1];
+		child.m_modules.clear();
+		child.m_position = 0;
+		child.m_parameter = 0;
+		RuleTable::Match match = m_rules->match(frame.m_modules, frame.m_position, frame.m_parameter, nullptr, m_contextParameters);
+		if (match.m_rule != nullptr)
+		{
+			Philox random(m_seed, m_level, index, Philox::REWRITE);
+			RuleTable::apply(RuleTable::choose(*match.m_rule, random), match.m_parameters, child.m_modules);
+			child.m_depth = m_level + 1;
+			if (m_level + 1 == lastLevel) m_isReplaced = true;
+		}
+		else
+		{
+			child.m_modules.append(symbol, parameters, arity);
+			child.m_depth = frame.m_depth;
+		}
+		++frame.m_position;
+		frame.m_parameter += arity;
+		++m_level;
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,261 @@
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "Expression.h"
+//----------------------------------------------------------------------------------------------------------------------
+constexpr unsigned Expression::s_maxStackSize;
+//----------------------------------------------------------------------------------------------------------------------
+Expression::Expression()
+{
+	m_code.push_back({CONSTANT, 0.0f, 0});
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool Expression::compile(const std::string& _source, const std::vector<std::string>& _parameterNames)
+{
+	m_code.clear();
+	Parser parser{_source, _parameterNames, 0};
+	bool isValid = parseOr(parser) && parser.m_position == _source.length();
+
+	//Find the deepest the stack gets, so evaluate can use a fixed size array
+	unsigned depth = 0;
+	for (const Instruction& i : m_code)
+	{
+		if (i.m_opcode == CONSTANT || i.m_opcode == PARAMETER) ++depth;
+		else if (i.m_opcode < NEGATE) --depth;
+		if (depth > s_maxStackSize) isValid = false;
+	}
+
+	if (!isValid)
+	{
+		m_code.clear();
+		m_code.push_back({CONSTANT, 0.0f, 0});
+	}
+	return isValid;
+}
+//----------------------------------------------------------------------------------------------------------------------
+float Expression::evaluate(const float* _parameters) const
+{
+	float stack[s_maxStackSize];
+	unsigned top = 0;
+	for (const Instruction& i : m_code)
+	{
+		switch (i.m_opcode)
+		{
+			case CONSTANT : stack[top++] = i.m_constant; break;
+			case PARAMETER : stack[top++] = _parameters[i.m_parameter]; break;
+			case NEGATE :
+			case NOT : stack[top-1] = apply(i.m_opcode, stack[top-1], 0.0f); break;
+			//Binary operators replace the top two values with the result
+			default :
+			{
+				--top;
+				stack[top-1] = apply(i.m_opcode, stack[top-1], stack[top]);
+				break;
+			}
+		}
+	}
+	return stack[0];
+}
+//----------------------------------------------------------------------------------------------------------------------
+float Expression::apply(OPCODE _opcode, float _a, float _b)
+{
+	switch (_opcode)
+	{
+		case ADD : return _a + _b;
+		case SUBTRACT : return _a - _b;
+		case MULTIPLY : return _a * _b;
+		case DIVIDE : return _a / _b;
+		case POWER : return std::pow(_a, _b);
+		case LESS : return _a < _b ? 1.0f : 0.0f;
+		case GREATER : return _a > _b ? 1.0f : 0.0f;
+		case LESS_EQUAL : return _a <= _b ? 1.0f : 0.0f;
+		case GREATER_EQUAL : return _a >= _b ? 1.0f : 0.0f;
+		case EQUAL : return _a == _b ? 1.0f : 0.0f;
+		case NOT_EQUAL : return _a != _b ? 1.0f : 0.0f;
+		case AND : return (_a != 0.0f && _b != 0.0f) ? 1.0f : 0.0f;
+		case OR : return (_a != 0.0f || _b != 0.0f) ? 1.0f : 0.0f;
+		case NEGATE : return -_a;
+		case NOT : return _a == 0.0f ? 1.0f : 0.0f;
+		default : return 0.0f;
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
+void Expression::emit(OPCODE _opcode)
+{
+	std::size_t size = m_code.size();
+	bool isUnary = _opcode >= NEGATE;
+
+	//Fold the operator if its operands are constants
+	if (isUnary && size >= 1 && m_code[size-1].m_opcode == CONSTANT)
+	{
+		m_code[size-1].m_constant = apply(_opcode, m_code[size-1].m_constant, 0.0f);
+	}
+	else if (!isUnary && size >= 2 && m_code[size-2].m_opcode == CONSTANT && m_code[size-1].m_opcode == CONSTANT)
+	{
+		m_code[size-2].m_constant = apply(_opcode, m_code[size-2].m_constant, m_code[size-1].m_constant);
+		m_code.pop_back();
+	}
+	else
+	{
+		m_code.push_back({_opcode, 0.0f, 0});
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool Expression::accept(Parser& _parser, const char* _operator)
+{
+	std::size_t length = std::strlen(_operator);
+	if (_parser.m_source.compare(_parser.m_position, length, _operator) != 0) return false;
+	_parser.m_position += length;
+	return true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool Expression::parseOr(Parser& _parser)
+{
+	if (!parseAnd(_parser)) return false;
+	while (accept(_parser, "||"))
+	{
+		if (!parseAnd(_parser)) return false;
+		emit(OR);
+	}
+	return true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool Expression::parseAnd(Parser& _parser)
+{
+	if (!parseComparison(_parser)) return false;
+	while (accept(_parser, "&&"))
+	{
+		if (!parseComparison(_parser)) return false;
+		emit(AND);
+	}
+	return true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool Expression::parseComparison(Parser& _parser)
+{
+	if (!parseSum(_parser)) return false;
+	while (true)
+	{
+		//The two character operators are checked first so <= isn't read as <
+		OPCODE opcode;
+		if (accept(_parser, "<=")) opcode = LESS_EQUAL;
+		else if (accept(_parser, ">=")) opcode = GREATER_EQUAL;
+		else if (accept(_parser, "==")) opcode = EQUAL;
+		else if (accept(_parser, "!=")) opcode = NOT_EQUAL;
+		else if (accept(_parser, "<")) opcode = LESS;
+		else if (accept(_parser, ">")) opcode = GREATER;
+		else return true;
+
+		if (!parseSum(_parser)) return false;
+		emit(opcode);
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool Expression::parseSum(Parser& _parser)
+{
+	if (!parseProduct(_parser)) return false;
+	while (true)
+	{
+		OPCODE opcode;
+		if (accept(_parser, "+")) opcode = ADD;
+		else if (accept(_parser, "-")) opcode = SUBTRACT;
+		else return true;
+
+		if (!parseProduct(_parser)) return false;
+		emit(opcode);
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool Expression::parseProduct(Parser& _parser)
+{
+	if (!parseUnary(_parser)) return false;
+	while (true)
+	{
+		OPCODE opcode;
+		if (accept(_parser, "*")) opcode = MULTIPLY;
+		else if (accept(_parser, "/")) opcode = DIVIDE;
+		else return true;
+
+		if (!parseUnary(_parser)) return false;
+		emit(opcode);
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool Expression::parseUnary(Parser& _parser)
+{
+	//-x^2 is -(x^2), as in mathematics
+	if (accept(_parser, "-"))
+	{
+		if (!parseUnary(_parser)) return false;
+		emit(NEGATE);
+		return true;
+	}
+	if (accept(_parser, "!"))
+	{
+		if (!parseUnary(_parser)) return false;
+		emit(NOT);
+		return true;
+	}
+	return parsePower(_parser);
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool Expression::parsePower(Parser& _parser)
+{
+	if (!parsePrimary(_parser)) return false;
+	if (accept(_parser, "^"))
+	{
+		//The exponent is parsed as a unary so x^-1 and x^y^z work
+		if (!parseUnary(_parser)) return false;
+		emit(POWER);
+	}
+	return true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool Expression::parsePrimary(Parser& _parser)
+{
+	const std::string& source = _parser.m_source;
+	std::size_t& position = _parser.m_position;
+	if (position >= source.length()) return false;
+	char c = source[position];
+
+	//Bracketed expression
+	if (c == '(')
+	{
+		++position;
+		if (!parseOr(_parser)) return false;
+		return accept(_parser, ")");
+	}
+
+	//Number
+	if (std::isdigit(static_cast<unsigned char>(c)) || c == '.')
+	{
+		const char* begin = source.c_str() + position;
+		char* end;
+		float value = std::strtof(begin, &end);
+		if (end == begin) return false;
+		position += static_cast<std::size_t>(end - begin);
+		m_code.push_back({CONSTANT, value, 0});
+		return true;
+	}
+
+	//Parameter name
+	if (std::isalpha(static_cast<unsigned char>(c)) || c == '_')
+	{
+		std::size_t end = position;
+		while (end < source.length() && (std::isalnum(static_cast<unsigned char>(source[end])) || source[end] == '_')) ++end;
+		std::string name = source.substr(position, end - position);
+		position = end;
+		for (unsigned i=0; i<_parser.m_parameterNames.size(); ++i)
+		{
+			if (_parser.m_parameterNames[i] == name)
+			{
+				m_code.push_back({PARAMETER, 0.0f, i});
+				return true;
+			}
+		}
+		return false;
+	}
+	return false;
+}
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,144 @@
+#include <fstream>
+#include "FrameStats.h"
+//----------------------------------------------------------------------------------------------------------------------
+unsigned FrameStats::s_drawCalls = 0;
+unsigned long long FrameStats::s_triangles = 0;
+unsigned long long FrameStats::s_instances = 0;
+//----------------------------------------------------------------------------------------------------------------------
+FrameStats::~FrameStats()
+{
+	if (m_isInitialised) glDeleteQueries(s_bufferedFrames * FrameRecord::s_phaseCount, m_queries[0].data());
+}
+//----------------------------------------------------------------------------------------------------------------------
+void FrameStats::beginFrame()
+{
+	//The queries are created here as the constructor may be called before there is a context
+	if (!m_isInitialised)
+	{
+		glGenQueries(s_bufferedFrames * FrameRecord::s_phaseCount, m_queries[0].data());
+		m_isInitialised = true;
+	}
+
+	//Collect the finished frames in order, starting with the oldest. That frame used the queries needed now,
+	//so it is waited for, which only happens if the GPU is more than s_bufferedFrames behind
+	m_current = m_frameCount % s_bufferedFrames;
+	for (unsigned i=0; i<s_bufferedFrames; ++i)
+	{
+		unsigned slot = (m_current + i) % s_bufferedFrames;
+		if (m_isPending[slot] && !collect(slot, i == 0)) break;
+	}
+
+	m_pending[m_current] = FrameRecord();
+	m_pending[m_current].m_frame = m_frameCount;
+	m_timedPhases[m_current] = 0;
+	s_drawCalls = 0;
+	s_triangles = 0;
+	s_instances = 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void FrameStats::beginPhase(PHASE _phase)
+{
+	m_phase = _phase;
+	m_timedPhases[m_current] |= 1u << _phase;
+	glBeginQuery(GL_TIME_ELAPSED, m_queries[m_current][_phase]);
+	m_phaseStart = std::chrono::steady_clock::now();
+}
+//----------------------------------------------------------------------------------------------------------------------
+void FrameStats::endPhase()
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - m_phaseStart;
+	m_pending[m_current].m_cpuTime[m_phase] += elapsed.count();
+	glEndQuery(GL_TIME_ELAPSED);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void FrameStats::endFrame()
+{
+	FrameRecord& record = m_pending[m_current];
+	record.m_drawCalls = s_drawCalls;
+	record.m_triangles = s_triangles;
+	record.m_instances = s_instances;
+	m_isPending[m_current] = true;
+	++m_frameCount;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void FrameStats::flush()
+{
+	//The oldest pending frame is the one after the last frame recorded
+	for (unsigned i=0; i<s_bufferedFrames; ++i)
+	{
+		unsigned slot = (m_frameCount + i) % s_bufferedFrames;
+		if (m_isPending[slot]) collect(slot, true);
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool FrameStats::collect(unsigned _slot, bool _wait)
+{
+	//The phases finish in order, so the results are ready once the last timed phase is
+	unsigned timed = m_timedPhases[_slot];
+	if (!_wait)
+	{
+		for (int p=FrameRecord::s_phaseCount-1; p>=0; --p)
+		{
+			if (!(timed & (1u << p))) continue;
+			GLuint isAvailable = GL_FALSE;
+			glGetQueryObjectuiv(m_queries[_slot][p], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+			if (!isAvailable) return false;
+			break;
+		}
+	}
+
+	FrameRecord& record = m_pending[_slot];
+	for (unsigned p=0; p<FrameRecord::s_phaseCount; ++p)
+	{
+		if (!(timed & (1u << p))) continue;
+		GLuint64 nanoseconds = 0;
+		glGetQueryObjectui64v(m_queries[_slot][p], GL_QUERY_RESULT, &nanoseconds);
+		record.m_gpuTime[p] = nanoseconds / 1e6;
+	}
+
+	m_latest = record;
+	m_history.push_back(record);
+	if (m_history.size() > s_maxHistory) m_history.pop_front();
+	m_isPending[_slot] = false;
+	return true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void FrameStats::recordDraw(unsigned _triangles, unsigned _instances)
+{
+	++s_drawCalls;
+	s_triangles += static_cast<unsigned long long>(_triangles) * _instances;
+	s_instances += _instances;
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool FrameStats::writeCSV(const std::string& _fileName) const
+{
+	std::ofstream fileOut(_fileName);
+	if (!fileOut.is_open()) return false;
+
+	fileOut << "frame";
+	for (unsigned p=0; p<FrameRecord::s_phaseCount; ++p) fileOut << ",cpu_" << phaseName(p) << "_ms";
+	for (unsigned p=0; p<FrameRecord::s_phaseCount; ++p) fileOut << ",gpu_" << phaseName(p) << "_ms";
+	fileOut << ",draw_calls,triangles,instances\n";
+
+	for (const FrameRecord& r : m_history)
+	{
+		fileOut << r.m_frame;
+		for (double t : r.m_cpuTime) fileOut << "," << t;
+		for (double t : r.m_gpuTime) fileOut << "," << t;
+		fileOut << "," << r.m_drawCalls << "," << r.m_triangles << "," << r.m_instances << "\n";
+	}
+	return fileOut.good();
+}
+//----------------------------------------------------------------------------------------------------------------------
+const char* FrameStats::phaseName(unsigned _phase)
+{
+	switch (_phase)
+	{
+		case SETUP: return "setup";
+		case GROUND: return "ground";
+		case PLANTS: return "plants";
+		case IMPOSTORS: return "impostors";
+		default: return "unknown";
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
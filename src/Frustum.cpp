@@ -0,0 +1,43 @@
+#include "Frustum.h"
+//----------------------------------------------------------------------------------------------------------------------
+Frustum::Frustum(const ngl::Mat4& _viewProjection)
+{
+	//NGL multiplies row vectors, so each clip coordinate is a column of the matrix
+	const ngl::Mat4& m = _viewProjection;
+	ngl::Vec4 x(m.m_00, m.m_10, m.m_20, m.m_30);
+	ngl::Vec4 y(m.m_01, m.m_11, m.m_21, m.m_31);
+	ngl::Vec4 z(m.m_02, m.m_12, m.m_22, m.m_32);
+	ngl::Vec4 w(m.m_03, m.m_13, m.m_23, m.m_33);
+
+	//Each plane is a comparison of a clip coordinate with w, e.g. the left plane is -w <= x
+	m_planes[0] = ngl::Vec4(w.m_x + x.m_x, w.m_y + x.m_y, w.m_z + x.m_z, w.m_w + x.m_w);//Left
+	m_planes[1] = ngl::Vec4(w.m_x - x.m_x, w.m_y - x.m_y, w.m_z - x.m_z, w.m_w - x.m_w);//Right
+	m_planes[2] = ngl::Vec4(w.m_x + y.m_x, w.m_y + y.m_y, w.m_z + y.m_z, w.m_w + y.m_w);//Bottom
+	m_planes[3] = ngl::Vec4(w.m_x - y.m_x, w.m_y - y.m_y, w.m_z - y.m_z, w.m_w - y.m_w);//Top
+	m_planes[4] = ngl::Vec4(w.m_x + z.m_x, w.m_y + z.m_y, w.m_z + z.m_z, w.m_w + z.m_w);//Near
+	m_planes[5] = ngl::Vec4(w.m_x - z.m_x, w.m_y - z.m_y, w.m_z - z.m_z, w.m_w - z.m_w);//Far
+}
+//----------------------------------------------------------------------------------------------------------------------
+Frustum::TEST Frustum::test(const AABB& _box) const
+{
+	//Nothing has been added to the box, so there is nothing to draw
+	if (_box.isEmpty()) return OUTSIDE;
+
+	TEST result = INSIDE;
+	for (const ngl::Vec4& p : m_planes)
+	{
+		//The corner furthest along the plane normal is the most likely to be inside
+		float furthest = p.m_x * (p.m_x > 0.0f ? _box.m_max.m_x : _box.m_min.m_x) +
+										 p.m_y * (p.m_y > 0.0f ? _box.m_max.m_y : _box.m_min.m_y) +
+										 p.m_z * (p.m_z > 0.0f ? _box.m_max.m_z : _box.m_min.m_z) + p.m_w;
+		if (furthest < 0.0f) return OUTSIDE;
+
+		//If the nearest corner is outside, the box crosses the plane
+		float nearest = p.m_x * (p.m_x > 0.0f ? _box.m_min.m_x : _box.m_max.m_x) +
+										p.m_y * (p.m_y > 0.0f ? _box.m_min.m_y : _box.m_max.m_y) +
+										p.m_z * (p.m_z > 0.0f ? _box.m_min.m_z : _box.m_max.m_z) + p.m_w;
+		if (nearest < 0.0f) result = INTERSECT;
+	}
+	return result;
+}
+//----------------------------------------------------------------------------------------------------------------------
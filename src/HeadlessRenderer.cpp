@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <ngl/Camera.h>
+#include <ngl/Util.h>
+#include "HeadlessRenderer.h"
+#include "PlantBlueprint.h"
+#include "SceneRenderer.h"
+//----------------------------------------------------------------------------------------------------------------------
+int HeadlessRenderer::run()
+{
+	if (!createCameraPath())
+	{
+		std::cerr << "Could not read the camera file " << m_options.m_cameraFile << "\n";
+		return 1;
+	}
+
+	//Create a context with an offscreen surface. On machines without a display this needs a platform plugin that
+	//supports GL without a window, e.g. QT_QPA_PLATFORM=offscreen, and Mesa llvmpipe can be forced with LIBGL_ALWAYS_SOFTWARE=1
+	QOffscreenSurface surface;
+	surface.setFormat(QSurfaceFormat::defaultFormat());
+	surface.create();
+	QOpenGLContext context;
+	context.setFormat(QSurfaceFormat::defaultFormat());
+	if (!context.create() || !context.makeCurrent(&surface))
+	{
+		std::cerr << "Could not create an OpenGL 3.3 core context\n";
+		return 1;
+	}
+
+	//Render into a framebuffer object instead of a window
+	QOpenGLFramebufferObjectFormat fboFormat;
+	fboFormat.setAttachment(QOpenGLFramebufferObject::Depth);
+	//This is declared after the context so it is deleted first
+	std::unique_ptr<QOpenGLFramebufferObject> framebuffer(new QOpenGLFramebufferObject(m_options.m_width, m_options.m_height, fboFormat));
+
+	QDir().mkpath(QString::fromStdString(m_options.m_outputDirectory));
+	std::ofstream timings(m_options.m_outputDirectory + "/timings.csv");
+	timings << "phase,index,milliseconds\n";
+
+	//The renderer is scoped so the plants are deleted while the context is current
+	{
+		SceneRenderer::initialisePresets();
+		for (const std::string& p : m_options.m_presets)
+		{
+			if (PlantBlueprint::keys().count(p) == 0)
+			{
+				std::cerr << "Unknown preset " << p << "\n";
+				return 1;
+			}
+			//Streamed plants are grown to the depth when they are created, so the updates below do nothing
+			if (m_options.m_streamDerivation)
+			{
+				PlantBlueprint::instance(p)->setMaxDepth(m_options.m_depth);
+				PlantBlueprint::instance(p)->setStreamDerivation(true);
+			}
+		}
+		Plant::seed(m_options.m_seed);
+
+		SceneRenderer renderer;
+		renderer.initGL();
+		renderer.setImpostorDistance(m_options.m_impostorDistance);
+
+		//Lay the plants out on a square grid centred at the origin
+		unsigned side = static_cast<unsigned>(std::ceil(std::sqrt(static_cast<float>(m_options.m_plantCount))));
+		float offset = (side - 1) * m_options.m_spacing / 2.0f;
+		QElapsedTimer timer;
+		timer.start();
+		for (unsigned i=0; i<m_options.m_plantCount; ++i)
+		{
+			const std::string& preset = m_options.m_presets[i % m_options.m_presets.size()];
+			renderer.createPlant(preset, (i % side) * m_options.m_spacing - offset, (i / side) * m_options.m_spacing - offset);
+		}
+		timings << "create,0," << timer.nsecsElapsed() / 1e6 << "\n";
+
+		//Grow the plants, timing each update
+		for (unsigned i=0; i<m_options.m_depth; ++i)
+		{
+			timer.restart();
+			renderer.updatePlants();
+			timings << "update," << i+1 << "," << timer.nsecsElapsed() / 1e6 << "\n";
+		}
+
+		ngl::Camera camera;
+		for (unsigned i=0; i<m_options.m_frames; ++i)
+		{
+			ngl::Vec3 eye, look;
+			cameraAtFrame(i, eye, look);
+			camera.set(eye, look, ngl::Vec3::up());
+			camera.setShape(45, static_cast<float>(m_options.m_width)/m_options.m_height, 0.001f, 60.0f);
+
+			//Wait for the GPU so the time includes the whole frame
+			timer.restart();
+			renderer.render(camera, framebuffer->handle(), m_options.m_width, m_options.m_height);
+			glFinish();
+			timings << "frame," << i << "," << timer.nsecsElapsed() / 1e6 << "\n";
+
+			if (m_options.m_writeImages)
+			{
+				QString fileName = QString("%1/frame_%2.png").arg(QString::fromStdString(m_options.m_outputDirectory)).arg(i, 4, 10, QChar('0'));
+				framebuffer->toImage().save(fileName);
+			}
+		}
+
+		//Write the per phase times and draw counts of every frame
+		renderer.stats().flush();
+		renderer.stats().writeCSV(m_options.m_outputDirectory + "/stats.csv");
+	}
+
+	framebuffer.reset();
+	context.doneCurrent();
+	return 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool HeadlessRenderer::createCameraPath()
+{
+	//Orbit the plants if there is no camera file
+	if (m_options.m_cameraFile.empty()) return true;
+
+	std::ifstream fileIn(m_options.m_cameraFile);
+	if (!fileIn.is_open()) return false;
+
+	std::string line;
+	while (std::getline(fileIn, line))
+	{
+		//Skip blank lines and comments
+		if (line.empty() || line[0] == '#') continue;
+		std::istringstream values(line);
+		ngl::Vec3 eye, look;
+		if (values >> eye.m_x >> eye.m_y >> eye.m_z >> look.m_x >> look.m_y >> look.m_z)
+		{
+			m_eyes.push_back(eye);
+			m_looks.push_back(look);
+		}
+	}
+	return !m_eyes.empty();
+}
+//----------------------------------------------------------------------------------------------------------------------
+void HeadlessRenderer::cameraAtFrame(unsigned _frame, ngl::Vec3& _eye, ngl::Vec3& _look) const
+{
+	//Orbit once around the grid over all the frames
+	if (m_eyes.empty())
+	{
+		unsigned side = static_cast<unsigned>(std::ceil(std::sqrt(static_cast<float>(m_options.m_plantCount))));
+		float radius = std::max(3.0f, side * m_options.m_spacing);
+		float theta = ngl::TWO_PI * _frame / std::max(1u, m_options.m_frames);
+		_eye = ngl::Vec3(radius * cos(theta), radius * 0.4f, radius * sin(theta));
+		_look = ngl::Vec3(0.0f, 0.5f, 0.0f);
+		return;
+	}
+
+	//Interpolate linearly between the keys, spread evenly over the frames
+	if (m_eyes.size() == 1 || m_options.m_frames < 2)
+	{
+		_eye = m_eyes[0];
+		_look = m_looks[0];
+		return;
+	}
+	float t = static_cast<float>(_frame) / (m_options.m_frames - 1) * (m_eyes.size() - 1);
+	unsigned key = std::min(static_cast<unsigned>(t), static_cast<unsigned>(m_eyes.size() - 2));
+	float blend = t - key;
+	_eye = m_eyes[key] + (m_eyes[key+1] - m_eyes[key]) * blend;
+	_look = m_looks[key] + (m_looks[key+1] - m_looks[key]) * blend;
+}
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,186 @@
+#include <cmath>
+#include <cstddef>
+#include <ngl/ShaderLib.h>
+#include <ngl/Util.h>
+#include "ImpostorAtlas.h"
+#include "PlantBlueprint.h"
+//----------------------------------------------------------------------------------------------------------------------
+const std::string ImpostorAtlas::s_shaderProgramName = "Impostor";
+//----------------------------------------------------------------------------------------------------------------------
+ImpostorAtlas::ImpostorAtlas() :
+	m_instanceBuffer({{3, 3, offsetof(ImpostorInstance, m_centre)}, {4, 1, offsetof(ImpostorInstance, m_radius)}, {5, 1, offsetof(ImpostorInstance, m_layer)}}, sizeof(ImpostorInstance))
+{
+	//Load the shader
+	ngl::ShaderLib *shader = ngl::ShaderLib::instance();
+	shader->createShaderProgram(s_shaderProgramName);
+	shader->loadShader(s_shaderProgramName, "shaders/Impostor.vertex.glsl", "shaders/Impostor.fragment.glsl");
+
+	//Create the texture array. Mipmaps would average thin branches and leaves with the transparent background until
+	//they fell below the alpha test, and impostors are only drawn far away where those levels are used, so there is
+	//only the base level
+	glGenTextures(1, &m_texture);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, m_texture);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, 0);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	allocate(16);
+
+	//Create the depth buffer, which is shared by all the layers
+	glGenRenderbuffers(1, &m_depthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_depthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, s_columns * s_viewSize, s_rows * s_viewSize);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+	glGenFramebuffers(1, &m_framebuffer);
+}
+//----------------------------------------------------------------------------------------------------------------------
+ImpostorAtlas::~ImpostorAtlas()
+{
+	glDeleteFramebuffers(1, &m_framebuffer);
+	glDeleteRenderbuffers(1, &m_depthBuffer);
+	glDeleteTextures(1, &m_texture);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void ImpostorAtlas::allocate(int _layers)
+{
+	glBindTexture(GL_TEXTURE_2D_ARRAY, m_texture);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, s_columns * s_viewSize, s_rows * s_viewSize, _layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	m_capacity = _layers;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void ImpostorAtlas::assignLayer(ImpostorHandle& _handle)
+{
+	//Keep the layer if it is still valid
+	if (_handle.m_layer >= 0 && _handle.m_generation == m_generation) return;
+
+	if (!m_freeLayers.empty())
+	{
+		_handle.m_layer = m_freeLayers.back();
+		m_freeLayers.pop_back();
+	}
+	else
+	{
+		//GL 3.3 can't copy between textures, so growing loses every layer and all the plants are captured again
+		if (m_layerCount == m_capacity)
+		{
+			allocate(m_capacity * 2);
+			++m_generation;
+			m_layerCount = 0;
+			m_freeLayers.clear();
+		}
+		_handle.m_layer = m_layerCount++;
+	}
+	_handle.m_generation = m_generation;
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool ImpostorAtlas::isCurrent(const ImpostorHandle& _handle) const
+{
+	return _handle.m_layer >= 0 && _handle.m_generation == m_generation && !_handle.m_isOutdated;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void ImpostorAtlas::release(ImpostorHandle& _handle)
+{
+	if (_handle.m_layer >= 0 && _handle.m_generation == m_generation) m_freeLayers.push_back(_handle.m_layer);
+	_handle.m_layer = -1;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void ImpostorAtlas::capture(Plant& _plant, GLuint _defaultFramebuffer)
+{
+	ImpostorHandle& handle = _plant.impostor();
+	assignLayer(handle);
+
+	//Save the state that is changed
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	GLfloat clearColour[4];
+	glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColour);
+
+	//Render to the layer, clearing to transparent so the background can be discarded
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_texture, 0, handle.m_layer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+	glViewport(0, 0, s_columns * s_viewSize, s_rows * s_viewSize);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	//Fit the views to the sphere around the bounding box
+	const AABB& bounds = _plant.bounds();
+	ngl::Vec3 centre = (bounds.m_min + bounds.m_max) * 0.5f;
+	float radius = (bounds.m_max - bounds.m_min).length() * 0.5f;
+	ngl::Mat4 projection = orthographic(radius, radius, 3.0f * radius);
+
+	//Capture each view in its own tile, looking horizontally at the centre
+	for (int i=0; i<s_viewCount; ++i)
+	{
+		glViewport((i % s_columns) * s_viewSize, (i / s_columns) * s_viewSize, s_viewSize, s_viewSize);
+		float theta = ngl::TWO_PI * i / s_viewCount;
+		ngl::Vec3 eye = centre + ngl::Vec3(cos(theta), 0.0f, sin(theta)) * (2.0f * radius);
+		_plant.drawUnculled(s_captureLOD, lookAt(eye, centre), projection, eye);
+	}
+	handle.m_isOutdated = false;
+
+	//Restore the state
+	glBindFramebuffer(GL_FRAMEBUFFER, _defaultFramebuffer);
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	glClearColor(clearColour[0], clearColour[1], clearColour[2], clearColour[3]);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void ImpostorAtlas::add(const Plant& _plant)
+{
+	const AABB& bounds = _plant.bounds();
+	ngl::Vec3 centre = (bounds.m_min + bounds.m_max) * 0.5f;
+	float radius = (bounds.m_max - bounds.m_min).length() * 0.5f;
+	m_instances.emplace_back(centre, radius, static_cast<float>(_plant.impostor().m_layer));
+}
+//----------------------------------------------------------------------------------------------------------------------
+void ImpostorAtlas::draw(const ngl::Mat4& _viewMatrix, const ngl::Mat4& _projectionMatrix, const ngl::Vec3& _eye)
+{
+	//Nothing to draw
+	if (m_instances.empty()) return;
+
+	glBindTexture(GL_TEXTURE_2D_ARRAY, m_texture);
+
+	ngl::ShaderLib *shader = ngl::ShaderLib::instance();
+	(*shader)[s_shaderProgramName]->use();
+	shader->setUniform("VP", _viewMatrix * _projectionMatrix);
+	shader->setUniform("viewerPos", _eye);
+
+	//The quads are turned to face the camera, so they can't be back facing
+	m_instanceBuffer.upload(PlantBlueprint::leaf(), m_instances.data(), m_instances.size());
+	glDisable(GL_CULL_FACE);
+	m_instanceBuffer.draw();
+	glEnable(GL_CULL_FACE);
+}
+//----------------------------------------------------------------------------------------------------------------------
+ngl::Mat4 ImpostorAtlas::lookAt(const ngl::Vec3& _eye, const ngl::Vec3& _target)
+{
+	//Calculate the camera axes
+	ngl::Vec3 back = _eye - _target;
+	back.normalize();
+	ngl::Vec3 right = ngl::Vec3::up().cross(back);
+	right.normalize();
+	ngl::Vec3 up = back.cross(right);
+
+	//NGL multiplies row vectors, so the axes are the columns and the translation is the last row
+	ngl::Mat4 view;
+	view.m_00 = right.m_x; view.m_01 = up.m_x; view.m_02 = back.m_x;
+	view.m_10 = right.m_y; view.m_11 = up.m_y; view.m_12 = back.m_y;
+	view.m_20 = right.m_z; view.m_21 = up.m_z; view.m_22 = back.m_z;
+	view.m_30 = -right.dot(_eye);
+	view.m_31 = -up.dot(_eye);
+	view.m_32 = -back.dot(_eye);
+	return view;
+}
+//----------------------------------------------------------------------------------------------------------------------
+ngl::Mat4 ImpostorAtlas::orthographic(float _halfSize, float _near, float _far)
+{
+	ngl::Mat4 projection;
+	projection.m_00 = 1.0f / _halfSize;
+	projection.m_11 = 1.0f / _halfSize;
+	projection.m_22 = -2.0f / (_far - _near);
+	projection.m_32 = -(_far + _near) / (_far - _near);
+	return projection;
+}
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,103 @@
+#include <utility>
+#include "FrameStats.h"
+#include "InstanceBuffer.h"
+//----------------------------------------------------------------------------------------------------------------------
+InstanceBuffer::InstanceBuffer(const std::vector<InstanceAttribute>& _layout, GLsizei _stride) :
+	m_layout(_layout),
+	m_stride(_stride){}
+//----------------------------------------------------------------------------------------------------------------------
+InstanceBuffer::~InstanceBuffer()
+{
+	//Zero handles are silently ignored by GL, so moved-from buffers are safe to destroy
+	glDeleteVertexArrays(1, &m_vao);
+	glDeleteBuffers(1, &m_vbo);
+}
+//----------------------------------------------------------------------------------------------------------------------
+InstanceBuffer::InstanceBuffer(InstanceBuffer&& _other) :
+	m_layout(_other.m_layout),
+	m_stride(_other.m_stride)
+{
+	*this = std::move(_other);
+}
+//----------------------------------------------------------------------------------------------------------------------
+InstanceBuffer& InstanceBuffer::operator=(InstanceBuffer&& _other)
+{
+	//Swap the handles so the other object deletes the old GL objects
+	std::swap(m_layout, _other.m_layout);
+	std::swap(m_stride, _other.m_stride);
+	std::swap(m_vao, _other.m_vao);
+	std::swap(m_vbo, _other.m_vbo);
+	std::swap(m_capacity, _other.m_capacity);
+	std::swap(m_indexCount, _other.m_indexCount);
+	std::swap(m_count, _other.m_count);
+	return *this;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void InstanceBuffer::upload(const Mesh& _mesh, const void* _data, unsigned _count)
+{
+	//Create the vertex array on the first upload
+	if (m_vao == 0)
+	{
+		glGenVertexArrays(1, &m_vao);
+		glGenBuffers(1, &m_vbo);
+		glBindVertexArray(m_vao);
+
+		//Share the mesh buffers
+		_mesh.bindAttributes();
+		m_indexCount = _mesh.indexCount();
+
+		//Set the per-instance attributes, which advance once per instance instead of once per vertex
+		glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+		for (const InstanceAttribute& a : m_layout)
+		{
+			glEnableVertexAttribArray(a.m_location);
+			glVertexAttribPointer(a.m_location, a.m_size, GL_FLOAT, GL_FALSE, m_stride, reinterpret_cast<GLvoid*>(a.m_offset));
+			glVertexAttribDivisor(a.m_location, 1);
+		}
+		glBindVertexArray(0);
+	}
+
+	//Copy the data, only reallocating when the buffer needs to grow
+	std::size_t size = static_cast<std::size_t>(_count) * m_stride;
+	glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+	if (size > m_capacity)
+	{
+		glBufferData(GL_ARRAY_BUFFER, size, _data, GL_DYNAMIC_DRAW);
+		m_capacity = size;
+	}
+	else if (size > 0)
+	{
+		glBufferSubData(GL_ARRAY_BUFFER, 0, size, _data);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	m_count = _count;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void InstanceBuffer::draw() const
+{
+	//Nothing to draw
+	if (m_count == 0) return;
+
+	drawRange(0, m_count);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void InstanceBuffer::drawRange(unsigned _first, unsigned _count) const
+{
+	//Nothing to draw
+	if (_count == 0) return;
+
+	glBindVertexArray(m_vao);
+
+	//Point the instance attributes at the first instance in the range
+	glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+	std::size_t base = static_cast<std::size_t>(_first) * m_stride;
+	for (const InstanceAttribute& a : m_layout)
+	{
+		glVertexAttribPointer(a.m_location, a.m_size, GL_FLOAT, GL_FALSE, m_stride, reinterpret_cast<GLvoid*>(base + a.m_offset));
+	}
+
+	glDrawElementsInstanced(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(_count));
+	glBindVertexArray(0);
+	FrameStats::recordDraw(static_cast<unsigned>(m_indexCount) / 3, _count);
+}
+//----------------------------------------------------------------------------------------------------------------------
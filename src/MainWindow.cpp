@@ -1,6 +1,8 @@
 #include <string>
 #include <unordered_set>
 #include <QApplication>
+#include <QFileDialog>
+#include <QMessageBox>
 #include <QString>
 #include "MainWindow.h"
 #include "PlantBlueprint.h"
@@ -45,6 +47,11 @@ MainWindow::MainWindow(QWidget *parent) :
 	connect(m_sceneManagerDialog->Ui().m_closeButton, SIGNAL(released()), this, SLOT(closeSceneManager()));
 	//Set the plant visibility
 	connect(m_sceneManagerDialog, SIGNAL(plantVisibility(uint,bool)), this, SLOT(setPlantVisibility(uint,bool)));
+	//Frame statistics
+	connect(m_ui->s_showStats, SIGNAL(toggled(bool)), this, SLOT(showStats(bool)));
+	connect(m_ui->s_exportStats, SIGNAL(triggered(bool)), this, SLOT(exportStats()));
+	//Impostor distance
+	connect(m_ui->m_impostorDistance, SIGNAL(valueChanged(double)), this, SLOT(setImpostorDistance(double)));
 
 	//Add all preset values
 	//m_ui->m_plantType->addItem("test");
@@ -148,6 +155,26 @@ void MainWindow::setPlantVisibility(unsigned _index, bool _state)
 	m_gl->setPlantVisibility(_index, _state);
 }
 //----------------------------------------------------------------------------------------------------------------------
+void MainWindow::showStats(bool _state)
+{
+	m_gl->setStatsOverlay(_state);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void MainWindow::setImpostorDistance(double _distance)
+{
+	m_gl->setImpostorDistance(static_cast<float>(_distance));
+}
+//----------------------------------------------------------------------------------------------------------------------
+void MainWindow::exportStats()
+{
+	QString fileName = QFileDialog::getSaveFileName(this, "Export Frame Statistics", "stats.csv", "CSV files (*.csv)");
+	if (fileName.isEmpty()) return;
+	if (!m_gl->exportStats(fileName.toStdString()))
+	{
+		QMessageBox::warning(this, "Export Frame Statistics", "Could not write " + fileName);
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
 void MainWindow::keyPressEvent(QKeyEvent *_event)
 {
 	switch (_event->key())
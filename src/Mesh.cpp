@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include "FrameStats.h"
+#include "Mesh.h"
+//----------------------------------------------------------------------------------------------------------------------
+Mesh::~Mesh()
+{
+	//Zero handles are silently ignored by GL, so moved-from meshes are safe to destroy
+	glDeleteVertexArrays(1, &m_vao);
+	glDeleteBuffers(1, &m_vbo);
+	glDeleteBuffers(1, &m_ibo);
+}
+//----------------------------------------------------------------------------------------------------------------------
+Mesh::Mesh(Mesh&& _other)
+{
+	*this = std::move(_other);
+}
+//----------------------------------------------------------------------------------------------------------------------
+Mesh& Mesh::operator=(Mesh&& _other)
+{
+	//Swap the handles so the other object deletes the old buffers
+	std::swap(m_vao, _other.m_vao);
+	std::swap(m_vbo, _other.m_vbo);
+	std::swap(m_ibo, _other.m_ibo);
+	std::swap(m_indexCount, _other.m_indexCount);
+	std::swap(m_vertexCapacity, _other.m_vertexCapacity);
+	std::swap(m_indexCapacity, _other.m_indexCapacity);
+	return *this;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void Mesh::setData(const std::vector<Vertex>& _vertices, const std::vector<GLuint>& _indices)
+{
+	//Discard the old data so the buffers are reallocated to the exact size
+	m_vertexCapacity = 0;
+	m_indexCapacity = 0;
+	appendData(_vertices, _indices, 0, 0);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void Mesh::appendData(const std::vector<Vertex>& _vertices, const std::vector<GLuint>& _indices, std::size_t _firstVertex, std::size_t _firstIndex)
+{
+	//Create the buffers on the first upload
+	if (m_vao == 0)
+	{
+		glGenVertexArrays(1, &m_vao);
+		glGenBuffers(1, &m_vbo);
+		glGenBuffers(1, &m_ibo);
+	}
+
+	//Copy the new data to the GPU
+	glBindVertexArray(m_vao);
+	appendToBuffer(GL_ARRAY_BUFFER, m_vbo, _vertices.data(), sizeof(Vertex), _vertices.size(), _firstVertex, m_vertexCapacity);
+	appendToBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo, _indices.data(), sizeof(GLuint), _indices.size(), _firstIndex, m_indexCapacity);
+	m_indexCount = static_cast<GLsizei>(_indices.size());
+
+	//Set the attributes for drawing the mesh on its own
+	bindAttributes();
+	glBindVertexArray(0);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void Mesh::appendToBuffer(GLenum _target, GLuint _buffer, const void* _data, std::size_t _elementSize, std::size_t _count, std::size_t _first, std::size_t& _capacity)
+{
+	glBindBuffer(_target, _buffer);
+
+	//Reallocate with room to grow, and copy everything since the old data is lost
+	if (_count > _capacity)
+	{
+		//Exact sized buffers are used for meshes that are set once
+		_capacity = (_capacity == 0) ? _count : std::max(_count, 2*_capacity);
+		glBufferData(_target, _capacity * _elementSize, nullptr, GL_DYNAMIC_DRAW);
+		_first = 0;
+	}
+
+	//Copy the data that is not on the GPU yet
+	if (_count > _first)
+	{
+		const char* data = static_cast<const char*>(_data);
+		glBufferSubData(_target, _first * _elementSize, (_count - _first) * _elementSize, data + _first * _elementSize);
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
+void Mesh::bindAttributes() const
+{
+	glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+
+	//Position
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<GLvoid*>(offsetof(Vertex, m_position)));
+	//UV
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<GLvoid*>(offsetof(Vertex, m_uv)));
+	//Normal
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<GLvoid*>(offsetof(Vertex, m_normal)));
+}
+//----------------------------------------------------------------------------------------------------------------------
+void Mesh::draw() const
+{
+	glBindVertexArray(m_vao);
+	glDrawElements(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, nullptr);
+	glBindVertexArray(0);
+	FrameStats::recordDraw(static_cast<unsigned>(m_indexCount) / 3);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void Mesh::drawRanges(const std::vector<GLsizei>& _counts, const std::vector<const GLvoid*>& _offsets) const
+{
+	//Nothing to draw
+	if (_counts.empty()) return;
+
+	glBindVertexArray(m_vao);
+	glMultiDrawElements(GL_TRIANGLES, _counts.data(), GL_UNSIGNED_INT, _offsets.data(), static_cast<GLsizei>(_counts.size()));
+	glBindVertexArray(0);
+	FrameStats::recordDraw(static_cast<unsigned>(std::accumulate(_counts.begin(), _counts.end(), 0) / 3));
+}
+//----------------------------------------------------------------------------------------------------------------------
+void Mesh::createPlane(std::vector<Vertex>& _vertices, std::vector<GLuint>& _indices)
+{
+	GLuint first = static_cast<GLuint>(_vertices.size());
+	_vertices.emplace_back(ngl::Vec3(-0.5f, 0.0f, -0.5f), ngl::Vec2(0.0f, 0.0f), ngl::Vec3::up());
+	_vertices.emplace_back(ngl::Vec3(-0.5f, 0.0f, 0.5f), ngl::Vec2(0.0f, 1.0f), ngl::Vec3::up());
+	_vertices.emplace_back(ngl::Vec3(0.5f, 0.0f, 0.5f), ngl::Vec2(1.0f, 1.0f), ngl::Vec3::up());
+	_vertices.emplace_back(ngl::Vec3(0.5f, 0.0f, -0.5f), ngl::Vec2(1.0f, 0.0f), ngl::Vec3::up());
+	//Counter clockwise when viewed from above
+	_indices.insert(_indices.end(), {first, first+1, first+2, first, first+2, first+3});
+}
+//----------------------------------------------------------------------------------------------------------------------
@@ -1,161 +1,130 @@
+#include <algorithm>
 #include <cmath>
-#include <stack>
-#include <ngl/Mat3.h>
-#include <ngl/Vec4.h>
-#include <ngl/ShaderLib.h>
+#include <cstddef>
+#include <iterator>
+#include <limits>
 #include <ngl/NGLStream.h>
 #include <ngl/VAOPrimitives.h>
 #include <ngl/Util.h>
+#include "Derivation.h"
 #include "Plant.h"
 //----------------------------------------------------------------------------------------------------------------------
 //Define static members
 std::random_device Plant::s_randomDevice;
-std::mt19937 Plant::s_numberGenerator(Plant::s_randomDevice());
+std::mt19937 Plant::s_seedGenerator(Plant::s_randomDevice());
+//Radial segments, node stride, leaf stride, max distance
+const std::array<LODSettings, Plant::s_lodCount> Plant::s_lodSettings = {{
+	{8, 1, 1, 15.0f},
+	{5, 2, 2, 35.0f},
+	{3, 0, 0, std::numeric_limits<float>::max()}
+}};
 //----------------------------------------------------------------------------------------------------------------------
-Plant::Plant(const std::string& _blueprint, const ngl::Vec3& _position)
+Plant::Plant(const std::string& _blueprint, const ngl::Vec3& _position) :
+	Plant(_blueprint, _position, static_cast<uint32_t>(s_seedGenerator()))
+{}
+//----------------------------------------------------------------------------------------------------------------------
+Plant::Plant(const std::string& _blueprint, const ngl::Vec3& _position, uint32_t _seed) :
+	m_seed(_seed)
 {
+	//Create the geometry containers for each level of detail
+	m_lods.reserve(s_lodCount);
+	for (const LODSettings& l : s_lodSettings)
+	{
+		m_lods.emplace_back(l.m_radialSegments);
+	}
+	//The most detailed level is always built as branches are evaluated
+	m_lods[0].m_isBuilt = true;
+
 	//Initialise the object
 	m_blueprint = PlantBlueprint::instance(_blueprint);
-	m_string = m_blueprint->axiom();
+	m_modules = m_blueprint->axiomModules();
 	m_position = _position;
 
-	//Initialise the simulation
+	//Initialise the simulation. A streamed plant is grown to the max depth at once
+	//The blueprint only streams grammars that can be, but the rules may have been read again since
+	if (m_blueprint->streamDerivation() && Derivation::canStream(m_blueprint->ruleTable()))
+	{
+		streamDerivation();
+		return;
+	}
 	stringToBranches();
 	evaluateBranches();
 }
 //----------------------------------------------------------------------------------------------------------------------
 Plant::~Plant(){}
 //----------------------------------------------------------------------------------------------------------------------
-void Plant::loadMatricesToShader(const ngl::Mat4 _viewMatrix, const ngl::Mat4 _projectionMatrix) const
+bool Plant::prepareDraw(const Frustum& _frustum)
+{
+	//Skip the plant entirely if it is off screen, before any GL work is issued
+	Frustum::TEST visibility = _frustum.test(m_bounds);
+	if (visibility == Frustum::OUTSIDE) return false;
+
+	//Per-branch culling is only worth it for nearby plants, which are the only ones with branch ranges
+	m_isPartiallyVisible = (visibility == Frustum::INTERSECT && m_lod == 0);
+	if (m_isPartiallyVisible) findVisibleRanges(_frustum);
+	prepareGeometry(m_lod);
+	return true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void Plant::drawBark() const
 {
-	ngl::ShaderLib *shader = ngl::ShaderLib::instance();
-	//Create the matrices
-	ngl::Mat4 M = m_transform;
-	ngl::Mat4 MV = M * _viewMatrix;
-	ngl::Mat4 MVP = MV * _projectionMatrix;
-	ngl::Mat3 N = MV;
-	N.inverse();
-	//Set the uniforms in the shader
-	shader->setUniform("M", M);
-	shader->setUniform("MV", MV);
-	shader->setUniform("MVP", MVP);
-	shader->setUniform("N", N);
-	//The texture does not need to tile
-	shader->setUniform("texScale", 1.0f);
+	//Draw all the branches with one draw call, or only the visible ones if the plant is partially on screen
+	const LODGeometry& geometry = m_lods[m_lod];
+	if (m_isPartiallyVisible) PlantBlueprint::drawBark(geometry.m_tubeMesh, m_visibleIndexCounts, m_visibleIndexOffsets);
+	else PlantBlueprint::drawBark(geometry.m_tubeMesh);
 }
 //----------------------------------------------------------------------------------------------------------------------
-//Rotation matrix found from https://en.wikipedia.org/wiki/Rotation_matrix
-ngl::Mat4 Plant::axisAngleRotationMatrix(const float& _angle, const ngl::Vec3& _axis) const
+void Plant::drawLeaves() const
 {
-	//Precompute trig functions
-	const float cosTheta = cos(_angle);
-	const float oneMinusCosTheta = 1 - cosTheta;
-	const float sinTheta = sin(_angle);
-
-	//Generate the rotation matrix
-	ngl::Mat4 rot;
-	rot.m_00 = cosTheta + _axis.m_x * _axis.m_x * oneMinusCosTheta;
-	rot.m_01 = _axis.m_y * _axis.m_x * oneMinusCosTheta + _axis.m_z * sinTheta;
-	rot.m_02 = _axis.m_z * _axis.m_x * oneMinusCosTheta - _axis.m_y * sinTheta;
-	rot.m_03 = 0.0f;
-
-	rot.m_10 = _axis.m_x * _axis.m_y * oneMinusCosTheta - _axis.m_z * sinTheta;
-	rot.m_11 = cosTheta + _axis.m_y * _axis.m_y * oneMinusCosTheta;
-	rot.m_12 = _axis.m_z * _axis.m_y * oneMinusCosTheta + _axis.m_x * sinTheta;
-	rot.m_13 = 0.0f;
-
-	rot.m_20 = _axis.m_x * _axis.m_z * oneMinusCosTheta + _axis.m_y * sinTheta;
-	rot.m_21 = _axis.m_y * _axis.m_z * oneMinusCosTheta - _axis.m_x * sinTheta;
-	rot.m_22 = cosTheta + _axis.m_z * _axis.m_z * oneMinusCosTheta;
-	rot.m_23 = 0.0f;
-
-	rot.m_30 = 0.0f;
-	rot.m_31 = 0.0f;
-	rot.m_32 = 0.0f;
-	rot.m_33 = 1.0f;
-
-	return rot;
+	const LODGeometry& geometry = m_lods[m_lod];
+	if (m_isPartiallyVisible) PlantBlueprint::drawLeaves(geometry.m_leafBuffer, m_visibleLeafRanges);
+	else PlantBlueprint::drawLeaves(geometry.m_leafBuffer);
 }
 //----------------------------------------------------------------------------------------------------------------------
-void Plant::draw(const ngl::Mat4 _viewMatrix, const ngl::Mat4 _projectionMatrix)
+void Plant::drawUnculled(unsigned _lod, const ngl::Mat4 _viewMatrix, const ngl::Mat4 _projectionMatrix, const ngl::Vec3& _eye)
 {
-	//Set some initial parameters
-	float decay = 1.0f;
-	ngl::Vec3 initialDirection = ngl::Vec3(0.0f,1.0f,0.0f);
+	prepareGeometry(_lod);
+	const LODGeometry& geometry = m_lods[_lod];
+
+	PlantBlueprint::beginBarkPass(_viewMatrix, _projectionMatrix, _eye);
+	PlantBlueprint::drawBark(geometry.m_tubeMesh);
+	PlantBlueprint::beginLeafPass(_viewMatrix, _projectionMatrix, _eye);
+	PlantBlueprint::drawLeaves(geometry.m_leafBuffer);
+	PlantBlueprint::endLeafPass();
+}
+//----------------------------------------------------------------------------------------------------------------------
+void Plant::prepareGeometry(unsigned _lod)
+{
+	//Simplified levels are only built once they are needed
+	if (!m_lods[_lod].m_isBuilt) buildLOD(_lod);
+	LODGeometry& geometry = m_lods[_lod];
 
-	//Draw each branch
-	for (Branch &b : m_branches)
+	//The geometry only changes when the simulation is updated, so it is uploaded here rather than every frame.
+	//This can't happen in updateSimulation as the GL context is only current while drawing
+	if (geometry.m_isOutdated)
 	{
-		//Pre-compute the decay for the branch
-		decay = calculateDecay(b.m_creationDepth);
-
-		//Draw the branch nodes
-		for (unsigned i=1; i<b.m_nodePositions.size(); ++i)
-		{
-			//Calculate the direction and length of the segment
-			ngl::Vec3 dir = b.m_nodePositions[i] - b.m_nodePositions[i-1];
-			float length = dir.length();
-			dir.normalize();
-
-			//Calculate the scale matrix
-			ngl::Mat4 scaleMatrix;
-			scaleMatrix.scale(m_blueprint->rootRadius()*decay, length, m_blueprint->rootRadius()*decay);
-
-			//Calculate the axis and angle for the rotation matrix
-			float angle = acos(initialDirection.dot(dir));
-			ngl::Mat4 rotationMatrix;
-			if (angle > 0)
-			{
-				ngl::Vec3 axis;
-				axis.cross(initialDirection, dir);
-				axis.normalize();
-				rotationMatrix = axisAngleRotationMatrix(angle, axis);
-			}
-
-			//Update the position
-			ngl::Vec3 position = b.m_nodePositions[i-1] + dir*length/2;
-			m_transform =  scaleMatrix * rotationMatrix;
-			m_transform.m_30 = position.m_x;
-			m_transform.m_31 = position.m_y;
-			m_transform.m_32 = position.m_z;
-
-			//Load the matrices to the shader and draw the branch part
-			loadMatricesToShader(_viewMatrix, _projectionMatrix);
-			PlantBlueprint::drawCylinder();
-		}
-
-		glDisable(GL_CULL_FACE);	//Disable face culling for the leaves
-		//Draw the leaves
-		ngl::Vec3 leafInitialDirection = ngl::Vec3(1.0f, 0.0f, 0.0f);
-		for (unsigned i=0; i<b.m_leafPositions.size(); ++i)
-		{
-			//Calculate the scale matrix
-			ngl::Mat4 scaleMatrix;
-			scaleMatrix.scale(m_blueprint->leafScale(), m_blueprint->leafScale(), m_blueprint->leafScale());
-
-			//Calculate the rotation matrix
-			float angle = acos(leafInitialDirection.dot(b.m_leafOrientations[i]));
-			ngl::Mat4 rotationMatrix;
-			if (angle > 0)	//The rotation matrix is undefined if the angle is 0
-			{
-				ngl::Vec3 axis;
-				axis.cross(leafInitialDirection, b.m_leafOrientations[i]);
-				axis.normalize();
-				rotationMatrix = axisAngleRotationMatrix(angle, axis);
-			}
-
-			//Calculate the model matrix
-			m_transform = scaleMatrix * rotationMatrix;
-			m_transform.m_30 = b.m_leafPositions[i].m_x;
-			m_transform.m_31 = b.m_leafPositions[i].m_y;
-			m_transform.m_32 = b.m_leafPositions[i].m_z;
-
-			//Load the matrices to the shader and draw the leaf
-			loadMatricesToShader(_viewMatrix, _projectionMatrix);
-			PlantBlueprint::drawLeaf();
-		}
-		glEnable(GL_CULL_FACE);	//Re-enable face culling for the branches
+		geometry.m_tubeMesh.upload();
+		geometry.m_leafBuffer.upload(PlantBlueprint::leaf(), geometry.m_leafInstances.data(), geometry.m_leafInstances.size());
+		geometry.m_isOutdated = false;
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
+void Plant::updateLOD(const ngl::Vec3& _eye, float _impostorDistance)
+{
+	//Find the distance to the closest point on the bounding box, so large plants don't drop detail while the camera is inside them
+	float distance = 0.0f;
+	if (!m_bounds.isEmpty())
+	{
+		ngl::Vec3 closest(std::max(m_bounds.m_min.m_x, std::min(_eye.m_x, m_bounds.m_max.m_x)),
+											std::max(m_bounds.m_min.m_y, std::min(_eye.m_y, m_bounds.m_max.m_y)),
+											std::max(m_bounds.m_min.m_z, std::min(_eye.m_z, m_bounds.m_max.m_z)));
+		distance = (closest - _eye).length();
 	}
+
+	//Only move to a coarser level once the plant is clearly past the threshold, and only move back once it is clearly inside
+	while (m_lod+1 < s_lodCount && distance > s_lodSettings[m_lod].m_maxDistance * (1.0f + s_lodHysteresis)) ++m_lod;
+	while (m_lod > 0 && distance < s_lodSettings[m_lod-1].m_maxDistance * (1.0f - s_lodHysteresis)) --m_lod;
+	m_isImpostor = distance > _impostorDistance * (m_isImpostor ? 1.0f - s_lodHysteresis : 1.0f + s_lodHysteresis);
 }
 //----------------------------------------------------------------------------------------------------------------------
 void Plant::updateSimulation()
@@ -163,106 +132,210 @@ void Plant::updateSimulation()
 	//Only update if the current depth is less than the max
 	if (m_depth < m_blueprint->maxDepth())
 	{
+		m_scratch.reset();
 		++m_depth;//Increment the depth of the expansion
 		stringRewrite();
 		evaluateBranches();
 	}
 }
 //----------------------------------------------------------------------------------------------------------------------
-float Plant::generateRandomFloat() const
+void Plant::addBranches(const std::vector<unsigned>& _positions)
 {
-	std::uniform_real_distribution<float> distribute(0,1);
-	return distribute(s_numberGenerator);
-}
-//----------------------------------------------------------------------------------------------------------------------
-unsigned Plant::countCharInString(const std::string& _string, const char& _c) const
-{
-	unsigned count = 0;
-	for (char c: _string)
-	{
-		if (c == _c) ++count;
-	}
-	return count;
-}
-//----------------------------------------------------------------------------------------------------------------------
-void Plant::addBranches(const unsigned& _number, unsigned& _position)
-{
-	for (unsigned i=0; i<_number; ++i, ++_position)
+	if (_positions.empty()) return;
+	std::vector<Branch>& branches = m_scratch.m_branches;
+	branches.clear();
+	branches.reserve(m_branches.size() + _positions.size());
+
+	//Move the existing branches across until the position of the next new branch is reached
+	auto existing = std::make_move_iterator(m_branches.begin());
+	auto end = std::make_move_iterator(m_branches.end());
+	for (unsigned p : _positions)
 	{
-		m_branches.emplace(m_branches.begin()+_position, m_depth);
+		while (branches.size() < p && existing != end) branches.emplace_back(*existing++);
+		branches.emplace_back(m_branchCount++, m_depth);
 	}
+	branches.insert(branches.end(), existing, end);
+	m_branches.swap(branches);
 }
 //----------------------------------------------------------------------------------------------------------------------
 void Plant::stringToBranches()
 {
-	unsigned numBranches = countCharInString(m_string, '[');
+	const Alphabet& alphabet = m_blueprint->alphabet();
+	unsigned numBranches = m_modules.count(Alphabet::PUSH);
 
-	//Initialise the start and end positions of branches in the string
+	//Each branch is the next run of modules between brackets - open or closed
+	unsigned i = 0;
 	std::size_t branchStartPos = 0;
-	std::size_t branchEndPos = 0;
-
-	for (unsigned i=0; i<numBranches; ++i)
+	std::size_t firstParameter = 0;
+	std::size_t parameterCount = 0;
+	for (std::size_t pos=0; pos<=m_modules.size() && i<numBranches; ++pos)
 	{
-		//The branch starts at the first character that's not a bracket
-		branchStartPos = m_string.find_first_not_of("[]", branchStartPos);
-		//The branch ends at the next bracket - open or closed
-		branchEndPos = m_string.find_first_of("[]", branchStartPos+1);
-
-		//Find a substring
-		std::string branchString = m_string.substr(branchStartPos, branchEndPos - branchStartPos);
+		bool isBranchEnd = pos == m_modules.size() || Alphabet::isBracket(m_modules[pos]);
+		if (isBranchEnd && pos > branchStartPos)
+		{
+			//Create a new branch if there are more runs than branches, otherwise update the span of the existing one
+			if (i == m_branches.size()) m_branches.emplace_back(m_branchCount++, m_depth);
+			Branch& b = m_branches[i];
+			b.m_firstModule = static_cast<unsigned>(branchStartPos);
+			b.m_moduleCount = static_cast<unsigned>(pos - branchStartPos);
+			b.m_firstParameter = static_cast<unsigned>(firstParameter);
+			++i;
+		}
 
-		//If the branch already exists, update the string
-		if (i<m_branches.size())
+		//Move the start of the branch past the bracket, or count the parameters of the module
+		if (isBranchEnd)
 		{
-			m_branches[i].m_string = branchString;
+			branchStartPos = pos+1;
+			firstParameter += parameterCount;
+			parameterCount = 0;
 		}
-		//Otherwise create a new branch with the string
 		else
 		{
-			m_branches.emplace_back(m_depth, branchString);
+			parameterCount += alphabet.arity(m_modules[pos]);
 		}
-		branchStartPos = branchEndPos+1;	//Increment the start position to check the next branch
 	}
 }
 //----------------------------------------------------------------------------------------------------------------------
 void Plant::stringRewrite()
 {
+	const RuleTable& rules = m_blueprint->ruleTable();
+	const Alphabet& alphabet = m_blueprint->alphabet();
+	const std::vector<float>& parameters = m_modules.parameters();
+
 	//Count the number of draw calls, will rerun this function if the count is the same
-	unsigned fCount = countCharInString(m_string, 'F');
+	unsigned fCount = m_modules.count(Alphabet::DRAW);
+	unsigned newFCount = 0;
 
-	std::string newString;	//Temporary new string to add to
-	bool isReplaced = false;//Check if a production rule was executed
+	ModuleString& newModules = m_scratch.m_modules;	//Temporary new modules to add to
+	newModules.clear();
+	newModules.reserve(rules.rewrittenLength(m_modules), parameters.size());//Allocate once rather than growing while appending
+
+	//Context sensitive rules need the neighbours of each module, which are found once for the whole rewrite
+	if (rules.hasContextRules()) m_scratch.m_context.build(m_modules, alphabet);
+	const ContextIndex* neighbours = rules.hasContextRules() ? &m_scratch.m_context : nullptr;
 
-	for (unsigned i=0, branchCount=0; i<m_string.length(); ++i)//Loop through each char in the string
+	//branchCount is the number of '[' in the new modules so far, which is where new branches are added
+	std::vector<unsigned>& newBranches = m_scratch.m_newBranches;
+	newBranches.clear();
+	std::size_t parameter = 0;
+	bool isReplaced = false;//Check if a production rule was executed
+	for (unsigned i=0, branchCount=0; i<m_modules.size();)//Loop through each module
 	{
-		isReplaced = false;
-		for (ProductionRule r : m_blueprint->productionRules())//Loop through the production rules
+		RuleTable::Match match = rules.match(m_modules, i, parameter, neighbours, m_scratch.m_contextParameters);//Walk the predecessor trie from this module
+		const RuleTable::Rule* r = match.m_rule;
+		if (r != nullptr)
 		{
-			if(r.m_predecessor == m_string.substr(i,r.m_predecessor.length()))//Check if a substring matches the rule predecessor
-			{
-				newString += r.m_successor;//Add the replaced rule
-				i += r.m_predecessor.length() - 1;//Iterate further through the original string if predecessor length > 1 char
-				isReplaced = true;
-				//Add new branches to the container
-				addBranches(countCharInString(r.m_successor, '['), branchCount);
-				break;//Avoid checking other rules
-			}
+			//Stochastic rules choose a successor from the plant seed, the rewrite and the position, so plants of the same
+			//blueprint differ but each plant is repeatable
+			Philox random(m_seed, m_rewriteCount, i, Philox::REWRITE);
+			const RuleTable::Successor& successor = RuleTable::choose(*r, random);
+			RuleTable::apply(successor, match.m_parameters, newModules);//Add the replaced rule
+			//Iterate further through the original modules if predecessor length > 1 module
+			for (std::size_t end=i+r->m_predecessor.size(); i<end; ++i) parameter += alphabet.arity(m_modules[i]);
+			newFCount += successor.m_drawCount;
+			isReplaced = true;
+			//Record where the new branches go, they are added to the container once the whole string is rewritten
+			for (unsigned b=0; b<successor.m_branchCount; ++b) newBranches.push_back(branchCount++);
+		}
+		else
+		{
+			//No replacement was made, so add the original module
+			uint8_t symbol = m_modules[i++];
+			if (symbol == Alphabet::PUSH) ++branchCount;
+			if (symbol == Alphabet::DRAW) ++newFCount;
+			unsigned arity = alphabet.arity(symbol);
+			newModules.append(symbol, parameters.data() + parameter, arity);
+			parameter += arity;
 		}
-		if (isReplaced == false) { newString += m_string[i]; }//No replacement was made, so add the original char
-		branchCount = countCharInString(newString, '[');
 	}
-	m_string = newString;//Assign the temp string to the member variable
+	std::swap(m_modules, newModules);//Swap in the new modules, the old ones are the buffer for the next rewrite
+	addBranches(newBranches);
+	++m_rewriteCount;
 
-	//Update the string in each branch
+	//Update the modules in each branch
 	stringToBranches();
 
 	//Check if the drawing will be the same, i.e. if this function needs to be rerun
-	if (countCharInString(m_string, 'F') == fCount)
+	//If no rule applied, e.g. every condition failed, rewriting again would give the same modules
+	if (newFCount == fCount && isReplaced)
 	{
 		stringRewrite();
 	}
 }
 //----------------------------------------------------------------------------------------------------------------------
+void Plant::streamDerivation()
+{
+	const Alphabet& alphabet = m_blueprint->alphabet();
+	//Find how many rewrites reach the max depth, so the modules and branch depths match rewriting update by update
+	std::vector<unsigned> levelDepths = Derivation::levelDepths(m_blueprint->ruleTable(), alphabet, m_seed, m_blueprint->axiomModules(), m_blueprint->maxDepth());
+	Derivation derivation(m_blueprint->ruleTable(), alphabet, m_seed);
+	derivation.start(m_blueprint->axiomModules(), static_cast<unsigned>(levelDepths.size()) - 1);
+	m_depth = m_blueprint->maxDepth();
+	m_rewriteCount = static_cast<unsigned>(levelDepths.size()) - 1;
+	m_modules.clear();
+
+	//The turtle state, and the state to return to at the end of each open branch
+	ngl::Vec3 position = m_position;
+	Quaternion frame;
+	unsigned depth = 0;
+	std::vector<ngl::Vec3>& positionStack = m_scratch.m_positionStack;
+	std::vector<Quaternion>& frameStack = m_scratch.m_frameStack;
+	std::vector<unsigned>& depthStack = m_scratch.m_depthStack;
+	positionStack.clear();
+	frameStack.clear();
+	depthStack.clear();
+
+	//Each run of modules between brackets is a branch, which is evaluated as soon as it ends
+	//A streamed plant never rewrites, so the rewrite buffer holds the run
+	ModuleString& run = m_scratch.m_modules;
+	run.clear();
+	auto endBranch = [&]()
+	{
+		if (run.empty()) return;
+		m_branches.emplace_back(m_branchCount++, depth);
+		Branch& b = m_branches.back();
+		b.m_moduleCount = static_cast<unsigned>(run.size());
+		evaluateBranch(b, run, position, frame);
+		position = lastNode(b);
+		frame = lastFrame(b);
+		//The run is reused for the next branch and the plant stores no modules, so the span is emptied
+		b.m_moduleCount = 0;
+		run.clear();
+	};
+
+	Derivation::Module module;
+	while (derivation.next(module))
+	{
+		if (module.m_symbol == Alphabet::PUSH)
+		{
+			endBranch();
+			positionStack.push_back(position);
+			frameStack.push_back(frame);
+			depthStack.push_back(depth);
+			//A branch was created at the plant depth of the rewrite that created its bracket
+			depth = levelDepths[module.m_depth];
+		}
+		else if (module.m_symbol == Alphabet::POP)
+		{
+			endBranch();
+			if (!positionStack.empty())
+			{
+				position = positionStack.back();
+				frame = frameStack.back();
+				depth = depthStack.back();
+				positionStack.pop_back();
+				frameStack.pop_back();
+				depthStack.pop_back();
+			}
+		}
+		else
+		{
+			run.append(module.m_symbol, module.m_parameters, alphabet.arity(module.m_symbol));
+		}
+	}
+	endBranch();
+}
+//----------------------------------------------------------------------------------------------------------------------
 float Plant::calculateDecay(const unsigned& _depth) const
 {
 	//Return 1 if the decay constant = 1. This avoids computing a pow
@@ -271,54 +344,56 @@ float Plant::calculateDecay(const unsigned& _depth) const
 	else return 1.0f / static_cast<float>(pow(m_blueprint->decayConstant(), _depth));
 }
 //----------------------------------------------------------------------------------------------------------------------
-void Plant::scatterLeaves(Branch& _branch, const ngl::Vec3 &_startPos, const ngl::Vec3 &_endPos, const float _radius, const ngl::Vec3& _direction)
+void Plant::scatterLeaves(Branch& _branch, const ngl::Vec3 &_startPos, const ngl::Vec3 &_endPos, const float _radius, const Quaternion& _frame)
 {
 	unsigned count = m_blueprint->leavesPerBranch() / m_blueprint->controlPointsPerBranch();//The number of leaves per node
 	float segmentLength = (_startPos - _endPos).length();//The length of the branch segment required for the unoriented cylinder height
 
-	//Calculate a rotation matrix to rotate a cylinder pointing up to the input direction
-	ngl::Vec3 axis;
-	axis.cross(_direction, ngl::Vec3::up());
-	float angle = acos(_direction.dot(ngl::Vec3::up()));
-	ngl::Mat4 rotationMatrix = axisAngleRotationMatrix(angle, axis);
+	//The leaves of each node have their own random numbers, so they don't depend on the order branches are evaluated in
+	Philox random(m_seed, _branch.m_id, _branch.m_nodeCount, Philox::LEAVES);
 
 	//Compute each leaf
 	for (unsigned i=0; i<count; ++i)
 	{
-		//Calculate a random point and its normal on the surface of a cylinder pointing up
-		float height = generateRandomFloat() * segmentLength;
-		float theta = generateRandomFloat() * ngl::TWO_PI;
-		ngl::Vec3 unorientedPosition(_radius * cos(theta), height, _radius * sin(theta));
-		ngl::Vec3 unorientedNormal(unorientedPosition.m_x, 0.0f, unorientedPosition.m_z);
-		unorientedNormal.normalize();
-
-		//Rotate the point and normal
-		ngl::Vec4 position = rotationMatrix * ngl::Vec4(unorientedPosition);
-
-		ngl::Vec4 normal = rotationMatrix * ngl::Vec4(unorientedNormal);
-		normal.normalize();
+		//Calculate a random point and its normal on the surface of a cylinder pointing up. The leaf model points along x,
+		//so turning it by -theta about the cylinder axis points it along the normal. Only the half angle is needed for that
+		float height = random.generateFloat() * segmentLength;
+		float halfTheta = random.generateFloat() * ngl::PI;
+		float cosHalf = cos(halfTheta);
+		float sinHalf = sin(halfTheta);
+		ngl::Vec3 unorientedNormal(cosHalf * cosHalf - sinHalf * sinHalf, 0.0f, 2.0f * sinHalf * cosHalf);
+		ngl::Vec3 unorientedPosition(_radius * unorientedNormal.m_x, height, _radius * unorientedNormal.m_z);
+		Quaternion aroundCylinder(cosHalf, 0.0f, -sinHalf, 0.0f);
+
+		//Rotate the point and normal from the cylinder pointing up into the frame of the segment
+		ngl::Vec3 position = _frame.rotate(unorientedPosition);
+		ngl::Vec3 normal = _frame.rotate(unorientedNormal);
 
 		//Add the original position and the normal
-		position += ngl::Vec4(_startPos) + normal * m_blueprint->leafScale() / 2;
+		position += _startPos + normal * m_blueprint->leafScale() / 2;
 
-		//Add a random rotation to the normal - this is a maximum of +- 15 degrees in each axis
-		normal.m_x += (generateRandomFloat() - 0.5f) * ngl::PI / 6;
-		normal.m_y += (generateRandomFloat() - 0.5f) * ngl::PI / 6;
-		normal.m_z += (generateRandomFloat() - 0.5f) * ngl::PI / 6;
+		//Add a random tilt to the leaf of at most about 15 degrees about each of its own axes. (1, v) is a rotation by
+		//2 * atan(|v|), so the tilt needs no trigonometry. 0.26 is twice tan(7.5 degrees)
+		Quaternion tilt(1.0f, (random.generateFloat() - 0.5f) * 0.26f, (random.generateFloat() - 0.5f) * 0.26f, (random.generateFloat() - 0.5f) * 0.26f);
+		tilt.normalize();
 
-		normal.normalize();	//Need to renormalise to account for the added random
+		//The leaf keeps the roll of the node frame, rather than being rebuilt from a direction
+		Quaternion orientation = _frame * aroundCylinder * tilt;
+		orientation.normalize();
 
 		//Store the position and orientation in the vectors in the branch
-		_branch.m_leafPositions.emplace_back(position.toVec3());
-		_branch.m_leafOrientations.emplace_back(normal.toVec3());
+		_branch.m_bounds.extend(position, m_blueprint->leafScale());
+		m_geometry.m_leafPositions.push_back(position);
+		m_geometry.m_leafOrientations.push_back(orientation);
+		++_branch.m_leafCount;
 	}
 }
 //----------------------------------------------------------------------------------------------------------------------
-void Plant::spaceColonisation(Branch& _branch, ngl::Vec3& _direction)
+void Plant::spaceColonisation(Branch& _branch, Quaternion& _frame, float _length)
 {
 	float decay = calculateDecay(_branch.m_creationDepth);	//Precompute the decay of the branch
-	float maxLength = m_blueprint->drawLength() * decay;//Max length of the branch bit
-	ngl::Vec3 pos = _branch.m_nodePositions.back();//Initialise position for this branch bit
+	float maxLength = _length;//Max length of the branch bit
+	ngl::Vec3 pos = lastNode(_branch);//Initialise position for this branch bit
 
 	//Create some segments
 	for (unsigned i=1; i<m_blueprint->controlPointsPerBranch(); ++i)
@@ -327,13 +402,15 @@ void Plant::spaceColonisation(Branch& _branch, ngl::Vec3& _direction)
 
 		//Predefine variables
 		float h, r, alpha;
+		//Each node has its own random numbers, keyed by the index of the node it creates
+		Philox random(m_seed, _branch.m_id, _branch.m_nodeCount, Philox::GROWTH);
 
 		//Generate a random length, radius and angle to create a random point inside a cone
 		if (m_blueprint->controlPointsPerBranch() > 2)
 		{
-			h = generateRandomFloat();
-			r = generateRandomFloat() * h * m_blueprint->maxDeviation();
-			alpha = generateRandomFloat() * ngl::TWO_PI;
+			h = random.generateFloat();
+			r = random.generateFloat() * h * m_blueprint->maxDeviation();
+			alpha = random.generateFloat() * ngl::TWO_PI;
 			h *= maxLength / m_blueprint->controlPointsPerBranch();
 		}
 		//Don't generata random values for height as this is a rigid L-system
@@ -341,7 +418,7 @@ void Plant::spaceColonisation(Branch& _branch, ngl::Vec3& _direction)
 		{
 			h = maxLength;
 			//If the max deviation > 0, compute a random deviation, otherwise set to 0
-			r = (m_blueprint->maxDeviation() > 0) ? generateRandomFloat() * h * m_blueprint->maxDeviation() : 0.0f;
+			r = (m_blueprint->maxDeviation() > 0) ? random.generateFloat() * h * m_blueprint->maxDeviation() : 0.0f;
 			alpha = 0.0f;
 		}
 
@@ -351,19 +428,12 @@ void Plant::spaceColonisation(Branch& _branch, ngl::Vec3& _direction)
 		randPoint.m_y = h;
 		randPoint.m_z = r * sin(alpha);
 
-		//Calculate a rotation matrix for the position
-		float angle = acos(_direction.dot(ngl::Vec3::up()));
-		ngl::Vec3 axis;
-		axis.cross(_direction, ngl::Vec3::up());
-		ngl::Mat4 rotationMatrix = axisAngleRotationMatrix(angle, axis);
-
-		//Calculate the new position and direction
-		ngl::Vec4 newPos = rotationMatrix * ngl::Vec4(randPoint, 1.0f);
-		newPos += ngl::Vec4(pos);
+		//Calculate the new position and direction, rotating the point from the cone pointing up into the turtle frame
+		ngl::Vec3 newPos = pos + _frame.rotate(randPoint);
 		//Make sure the branch doesn't go below ground
 		if (newPos.m_y <= 0.0f) newPos.m_y *=-1;
-		_direction = newPos.toVec3() - pos;
-		float nodeLength = _direction.length();
+		ngl::Vec3 direction = newPos - pos;
+		float nodeLength = direction.length();
 
 		//Add phototrophism if applicable
 		if (m_blueprint->phototropismScaleFactor() > 0)
@@ -371,25 +441,30 @@ void Plant::spaceColonisation(Branch& _branch, ngl::Vec3& _direction)
 			ngl::Vec3 phototropism = PlantBlueprint::sunPosition() - pos;//Calculate the direction to the sun
 			phototropism.normalize();
 			phototropism *= m_blueprint->phototropismScaleFactor() * decay;
-			_direction += phototropism;
+			direction += phototropism;
 		}
 		//Add gravitropism if applicable
 		if (m_blueprint->gravitropismScaleFactor() > 0)
 		{
 			ngl::Vec3 gravitropism = ngl::Vec3::down() * m_blueprint->gravitropismScaleFactor() * decay;
-			_direction += gravitropism;
+			direction += gravitropism;
 		}
 		//Calculate the new position
-		_direction.normalize();
-		pos += _direction * nodeLength;
+		direction.normalize();
+		pos += direction * nodeLength;
+		//Turn the frame onto the new direction by the smallest rotation, so it doesn't roll along the branch
+		_frame = Quaternion::between(_frame.heading(), direction) * _frame;
+		_frame.normalize();
 
-		//Add the position to the end of the array
-		_branch.m_nodePositions.emplace_back(pos);
+		//Add the position and frame to the end of the arrays
+		m_geometry.m_nodes.push_back(pos);
+		m_geometry.m_nodeFrames.push_back(_frame);
+		++_branch.m_nodeCount;
 
 		//Calculate leaves
 		if (_branch.m_creationDepth >= m_blueprint->leavesStartDepth())
 		{
-			scatterLeaves(_branch ,startPos, pos, decay * m_blueprint->rootRadius(), _direction);
+			scatterLeaves(_branch ,startPos, pos, _branch.m_radius, _frame);
 		}
 	}
 }
@@ -397,11 +472,13 @@ void Plant::spaceColonisation(Branch& _branch, ngl::Vec3& _direction)
 void Plant::evaluateBranches()
 {
 	//Create a stack of positions used to start new branches
-	std::stack<ngl::Vec3> positionStack;
-	positionStack.emplace(m_position);//Initialise with plant position
-	//Create a stack of directions for branch starting directions
-	std::stack<ngl::Vec3> directionStack;
-	directionStack.emplace(ngl::Vec3::up());//Initialise with the up vector
+	std::vector<ngl::Vec3>& positionStack = m_scratch.m_positionStack;
+	positionStack.clear();
+	positionStack.push_back(m_position);//Initialise with plant position
+	//Create a stack of turtle frames for branch starting frames
+	std::vector<Quaternion>& frameStack = m_scratch.m_frameStack;
+	frameStack.clear();
+	frameStack.push_back(Quaternion());//Initialise with the identity, which points up
 
 	unsigned lastBranchDepth = 0;
 	for (auto &b : m_branches)
@@ -409,94 +486,191 @@ void Plant::evaluateBranches()
 		//Pop values off the stack
 		for (unsigned i=b.m_creationDepth; i<=lastBranchDepth; ++i)
 		{
-			if (positionStack.size() > 1) positionStack.pop();
-			if (directionStack.size() > 1) directionStack.pop();
+			if (positionStack.size() > 1) positionStack.pop_back();
+			if (frameStack.size() > 1) frameStack.pop_back();
 		}
 
 		//Add the last position to the position stack
 		//This is to avoid resimulating the branch
-		if (!b.m_nodePositions.empty())
+		if (b.m_nodeCount > 0)
 		{
-			ngl::Vec3 direction = b.m_nodePositions.back() - b.m_nodePositions.front();
-			directionStack.push(direction);
-			positionStack.push(b.m_nodePositions.back());
+			frameStack.push_back(lastFrame(b));
+			positionStack.push_back(lastNode(b));
 		}
 		//Perform the space colonisation algorithm
 		else
 		{
-			b.m_nodePositions.emplace_back(positionStack.top());//Initialise the start position of the branch
-			ngl::Vec3 direction = directionStack.top();//Create a temporary variable for the direction of the branch nodes
-
-			// evaluate the string to find the new direction
-			for (char c : b.m_string)
-			{
-				switch (c)
-				{
-					//Rotate by +theta on the xy plane
-					case '/' :
-					{
-						ngl::Mat3 r;
-						r.rotateZ(m_blueprint->drawAngle());
-						direction = r * direction;
-						break;
-					}
-					//Rotate by -theta on the xy plane
-					case '\\' :
-					{
-						ngl::Mat3 r;
-						r.rotateZ(-m_blueprint->drawAngle());
-						direction = r * direction;
-						break;
-					}
-					//Rotate by +theta on the yz plane
-					case '+' :
-					{
-						ngl::Mat3 r;
-						r.rotateX(m_blueprint->drawAngle());
-						direction = r * direction;
-						break;
-					}
-					//Rotate by -theta on the yz plane
-					case '-' :
-					{
-						ngl::Mat3 r;
-						r.rotateX(-m_blueprint->drawAngle());
-						direction = r * direction;
-						break;
-					}
-					//Rotate by +theta on the xz plane
-					case '&' :
-					{
-						ngl::Mat3 r;
-						r.rotateY(m_blueprint->drawAngle());
-						direction = r * direction;
-						break;
-					}
-					//Rotate by -theta on the xz plane
-					case '^' :
-					{
-						ngl::Mat3 r;
-						r.rotateY(-m_blueprint->drawAngle());
-						direction = r * direction;
-						break;
-					}
-					//Do some space colonisation in the current direction
-					case 'F' :
-					{
-						direction.normalize();
-						spaceColonisation(b, direction);
-						break;
-					}
-					default : break;
-				}//End switch
-			}//End for [char]
+			evaluateBranch(b, m_modules, positionStack.back(), frameStack.back());
 
 			// update the stacks
-			positionStack.push(b.m_nodePositions.back());
-			directionStack.push(b.m_nodePositions.back() - b.m_nodePositions.front());
-
+			positionStack.push_back(lastNode(b));
+			frameStack.push_back(lastFrame(b));
 		}//End else condition
 		lastBranchDepth = b.m_creationDepth;
 	}//End for [branches]
 }
 //----------------------------------------------------------------------------------------------------------------------
+void Plant::evaluateBranch(Branch& _branch, const ModuleString& _modules, const ngl::Vec3& _position, Quaternion _frame)
+{
+	const Alphabet& alphabet = m_blueprint->alphabet();
+	const TurtleTable& turtle = m_blueprint->turtleTable();
+
+	//The nodes and leaves of the branch are added to the end of the plant geometry while it is evaluated
+	_branch.m_firstNode = static_cast<unsigned>(m_geometry.m_nodes.size());
+	_branch.m_firstLeaf = static_cast<unsigned>(m_geometry.m_leafPositions.size());
+	m_geometry.m_nodes.push_back(_position);//Initialise the start position of the branch
+	m_geometry.m_nodeFrames.push_back(_frame);
+	_branch.m_nodeCount = 1;
+	_branch.m_radius = calculateDecay(_branch.m_creationDepth) * m_blueprint->rootRadius();
+
+	// evaluate the modules to find the new frame
+	const float* parameters = _modules.parameters().data();
+	std::size_t parameter = _branch.m_firstParameter;
+	for (std::size_t i=_branch.m_firstModule; i<_branch.m_firstModule+_branch.m_moduleCount; ++i)
+	{
+		uint8_t symbol = _modules[i];
+		unsigned arity = alphabet.arity(symbol);
+		const float* p = parameters + parameter;
+		parameter += arity;
+
+		//Rotations turn the frame about its own axes, so they are applied after it. They use the blueprint table, and only a
+		//rotation with its own angle parameter computes a quaternion
+		if (TurtleTable::isRotation(symbol))
+		{
+			_frame = _frame * (arity > 0 ? TurtleTable::rotation(symbol, p[0]) : turtle.rotation(symbol));
+		}
+		//Do some space colonisation along the current heading
+		//F(l) sets the length and F(l,w) also sets the radius of the branch
+		else if (symbol == Alphabet::DRAW)
+		{
+			float length = arity > 0 ? p[0] : m_blueprint->drawLength() * calculateDecay(_branch.m_creationDepth);
+			if (arity > 1) _branch.m_radius = p[1];
+			spaceColonisation(_branch, _frame, length);
+		}
+	}//End for [module]
+	//Bound the nodes with the final radius, which is the one the branch is swept with
+	_branch.m_bounds.extend(m_geometry.m_nodes.x() + _branch.m_firstNode, m_geometry.m_nodes.y() + _branch.m_firstNode,
+						m_geometry.m_nodes.z() + _branch.m_firstNode, _branch.m_nodeCount, _branch.m_radius);
+
+	//Cache the draw data of the new branch
+	bakeBranch(_branch);
+	m_bounds.extend(_branch.m_bounds);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void Plant::bakeBranch(Branch& _branch)
+{
+	LODGeometry& geometry = m_lods[0];
+
+	//Sweep the branch radius along the nodes, and store the index range for culling
+	_branch.m_firstIndex = static_cast<unsigned>(geometry.m_tubeMesh.indexCount());
+	geometry.m_tubeMesh.addBranch(m_geometry.m_nodes, _branch.m_firstNode, _branch.m_nodeCount, 1, _branch.m_radius);
+	_branch.m_indexCount = static_cast<unsigned>(geometry.m_tubeMesh.indexCount()) - _branch.m_firstIndex;
+
+	//Add the leaves, which are instances m_firstLeaf onwards as the leaves of every earlier branch are already added
+	for (unsigned i=_branch.m_firstLeaf; i<_branch.m_firstLeaf+_branch.m_leafCount; ++i)
+	{
+		geometry.m_leafInstances.emplace_back(m_geometry.m_leafPositions[i], m_geometry.m_leafOrientations[i], m_blueprint->leafScale());
+	}
+	geometry.m_isOutdated = true;
+
+	//The simplified levels and the impostor are rebuilt from scratch the next time they are drawn
+	m_impostor.m_isOutdated = true;
+	for (unsigned i=1; i<s_lodCount; ++i)
+	{
+		m_lods[i].m_isBuilt = false;
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
+void Plant::buildLOD(unsigned _lod)
+{
+	const LODSettings& settings = s_lodSettings[_lod];
+	LODGeometry& geometry = m_lods[_lod];
+	geometry.m_tubeMesh.clear();
+	geometry.m_leafInstances.clear();
+
+	//Count the nodes that are kept, so the mesh is allocated once for the whole rebuild
+	std::size_t nodeCount = 0;
+	for (const Branch& b : m_branches)
+	{
+		nodeCount += TubeMesh::sweptNodeCount(b.m_nodeCount, settings.m_nodeStride);
+	}
+	geometry.m_tubeMesh.reserve(nodeCount, m_branches.size());
+
+	for (const Branch& b : m_branches)
+	{
+		//Skip the intermediate nodes, always keeping the start and end of the branch
+		geometry.m_tubeMesh.addBranch(m_geometry.m_nodes, b.m_firstNode, b.m_nodeCount, settings.m_nodeStride, b.m_radius);
+
+		if (b.m_leafCount == 0) continue;
+
+		//Keep every nth leaf, scaled so the leaves cover roughly the same area
+		if (settings.m_leafStride > 0)
+		{
+			float scale = m_blueprint->leafScale() * std::sqrt(static_cast<float>(settings.m_leafStride));
+			for (unsigned i=b.m_firstLeaf; i<b.m_firstLeaf+b.m_leafCount; i+=settings.m_leafStride)
+			{
+				geometry.m_leafInstances.emplace_back(m_geometry.m_leafPositions[i], m_geometry.m_leafOrientations[i], scale);
+			}
+		}
+		//Replace all the leaves of the branch with one card at their centre, with their average orientation
+		else
+		{
+			ngl::Vec3 centre(0.0f, 0.0f, 0.0f);
+			Quaternion orientation(0.0f, 0.0f, 0.0f, 0.0f);
+			for (unsigned i=b.m_firstLeaf; i<b.m_firstLeaf+b.m_leafCount; ++i)
+			{
+				centre += m_geometry.m_leafPositions[i];
+				//q and -q are the same rotation, so flip each one onto the side of the running sum before adding it
+				const Quaternion& leaf = m_geometry.m_leafOrientations[i];
+				orientation = orientation + (orientation.dot(leaf) < 0.0f ? -leaf : leaf);
+			}
+			float count = static_cast<float>(b.m_leafCount);
+			centre /= count;
+			if (orientation.dot(orientation) > 0.0f) orientation.normalize();
+			else orientation = Quaternion();
+			geometry.m_leafInstances.emplace_back(centre, orientation, m_blueprint->leafScale() * std::sqrt(count));
+		}
+	}
+	geometry.m_isBuilt = true;
+	geometry.m_isOutdated = true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void Plant::findVisibleRanges(const Frustum& _frustum)
+{
+	m_visibleIndexCounts.clear();
+	m_visibleIndexOffsets.clear();
+	m_visibleLeafRanges.clear();
+
+	unsigned indexRangeEnd = 0;
+	for (const Branch& b : m_branches)
+	{
+		if (_frustum.test(b.m_bounds) == Frustum::OUTSIDE) continue;
+
+		//Extend the last range if this branch follows it in the buffer, otherwise start a new range
+		if (b.m_indexCount > 0)
+		{
+			if (!m_visibleIndexCounts.empty() && indexRangeEnd == b.m_firstIndex)
+			{
+				m_visibleIndexCounts.back() += static_cast<GLsizei>(b.m_indexCount);
+			}
+			else
+			{
+				m_visibleIndexCounts.push_back(static_cast<GLsizei>(b.m_indexCount));
+				m_visibleIndexOffsets.push_back(reinterpret_cast<const GLvoid*>(b.m_firstIndex * sizeof(GLuint)));
+			}
+			indexRangeEnd = b.m_firstIndex + b.m_indexCount;
+		}
+		if (b.m_leafCount > 0)
+		{
+			if (!m_visibleLeafRanges.empty() && m_visibleLeafRanges.back().first + m_visibleLeafRanges.back().second == b.m_firstLeaf)
+			{
+				m_visibleLeafRanges.back().second += b.m_leafCount;
+			}
+			else
+			{
+				m_visibleLeafRanges.emplace_back(b.m_firstLeaf, b.m_leafCount);
+			}
+		}
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
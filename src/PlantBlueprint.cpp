@@ -1,18 +1,20 @@
 #include <algorithm>
 #include <cstdlib>
 #include <fstream>
+#include <iostream>
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
 #include <ngl/Texture.h>
-#include <ngl/VAOPrimitives.h>
+#include "Derivation.h"
 #include "PlantBlueprint.h"
 //----------------------------------------------------------------------------------------------------------------------
 // Set the static members
 std::unordered_map<std::string, PlantBlueprint*> PlantBlueprint::s_instances;
 std::unordered_set<std::string> PlantBlueprint::s_keys;
-std::string PlantBlueprint::s_shaderProgramName = "Phong";
-std::unique_ptr<ngl::Obj> PlantBlueprint::s_cylinder;
-std::string PlantBlueprint::s_leafGeometryName = "leafQuad";
+std::string PlantBlueprint::s_barkShaderProgramName = "Bark";
+std::string PlantBlueprint::s_leafShaderProgramName = "Leaf";
+GLuint PlantBlueprint::s_barkTexture;
+std::unique_ptr<Mesh> PlantBlueprint::s_leaf;
 GLuint PlantBlueprint::s_leafGeometryTexture;
 ngl::Vec3 PlantBlueprint::s_sunPosition = ngl::Vec3(0.0f, 100.0f, 0.0f);
 //----------------------------------------------------------------------------------------------------------------------
@@ -49,46 +51,91 @@ void PlantBlueprint::init()
 	//Define at exit handler
 	std::atexit(destroyAll);
 
-	//Create the cylinder mesh
-	s_cylinder.reset(new ngl::Obj("models/Cylinder.obj", "textures/TreeTexture.jpg"));
-	s_cylinder->createVAO();
-
 	//Create the leaf geometry
-	ngl::VAOPrimitives *prim = ngl::VAOPrimitives::instance();
-	prim->createTrianglePlane(s_leafGeometryName,1,1,1,1,ngl::Vec3::up());
+	std::vector<Vertex> vertices;
+	std::vector<GLuint> indices;
+	Mesh::createPlane(vertices, indices);
+	s_leaf.reset(new Mesh);
+	s_leaf->setData(vertices, indices);
 
-	//Load the shaders
+	//Load the shaders. The bark is opaque, so it uses the Blinn-Phong fragment shader without an alpha test
 	ngl::ShaderLib *shader = ngl::ShaderLib::instance();
-	shader->createShaderProgram(s_shaderProgramName);
-	const std::string vertexShader = "shaders/BlinnPhong.vertex.glsl";
-	const std::string fragmentShader = "shaders/BlinnPhong.fragment.glsl";
-	shader->loadShader(s_shaderProgramName,vertexShader, fragmentShader);
-	//Use the shader
-	(*shader)[s_shaderProgramName]->use();
+	shader->createShaderProgram(s_barkShaderProgramName);
+	shader->loadShader(s_barkShaderProgramName, "shaders/BlinnPhong.vertex.glsl", "shaders/BlinnPhong.fragment.glsl");
+	//The model matrix is always the identity and the texture does not tile, so these are only set once
+	(*shader)[s_barkShaderProgramName]->use();
+	shader->setUniform("M", ngl::Mat4());
+	shader->setUniform("texScale", 1.0f);
+	//The leaf shader builds the model matrix from the leaf position, orientation and scale attributes,
+	//and discards the transparent parts of the leaf texture
+	shader->createShaderProgram(s_leafShaderProgramName);
+	shader->loadShader(s_leafShaderProgramName, "shaders/Leaf.vertex.glsl", "shaders/Leaf.fragment.glsl");
+	(*shader)[s_leafShaderProgramName]->use();
+	shader->setUniform("texScale", 1.0f);
 
 	//Set the leaf texture
 	ngl::Texture leafTex("textures/Leaves0203.png");
 	s_leafGeometryTexture = leafTex.setTextureGL();
+
+	//Set the bark texture
+	ngl::Texture barkTex("textures/TreeTexture.jpg");
+	s_barkTexture = barkTex.setTextureGL();
 }
 //----------------------------------------------------------------------------------------------------------------------
-void PlantBlueprint::drawCylinder()
+void PlantBlueprint::beginBarkPass(const ngl::Mat4& _viewMatrix, const ngl::Mat4& _projectionMatrix, const ngl::Vec3& _eye)
 {
 	ngl::ShaderLib *shader = ngl::ShaderLib::instance();
-	(*shader)[s_shaderProgramName]->use();
-	s_cylinder->draw();
+	(*shader)[s_barkShaderProgramName]->use();
+	//The model matrix is the identity, so MV is the view matrix
+	ngl::Mat3 N = _viewMatrix;
+	N.inverse();
+	shader->setUniform("MV", _viewMatrix);
+	shader->setUniform("MVP", _viewMatrix * _projectionMatrix);
+	shader->setUniform("N", N);
+	shader->setUniform("viewerPos", _eye);
+
+	//Bind the texture once for all the branches
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, s_barkTexture);
 }
 //----------------------------------------------------------------------------------------------------------------------
-void PlantBlueprint::drawLeaf()
+void PlantBlueprint::beginLeafPass(const ngl::Mat4& _viewMatrix, const ngl::Mat4& _projectionMatrix, const ngl::Vec3& _eye)
 {
 	ngl::ShaderLib *shader = ngl::ShaderLib::instance();
-	(*shader)[s_shaderProgramName]->use();
+	(*shader)[s_leafShaderProgramName]->use();
+	shader->setUniform("V", _viewMatrix);
+	shader->setUniform("VP", _viewMatrix * _projectionMatrix);
+	shader->setUniform("viewerPos", _eye);
 
-	//Bind the texture before drawing
+	//Bind the texture once for all the leaves
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, s_leafGeometryTexture);
 
-	ngl::VAOPrimitives *prim = ngl::VAOPrimitives::instance();
-	prim->draw(s_leafGeometryName);
+	//Both sides of the leaves are visible
+	glDisable(GL_CULL_FACE);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void PlantBlueprint::drawBark(const TubeMesh& _mesh)
+{
+	_mesh.draw();
+}
+//----------------------------------------------------------------------------------------------------------------------
+void PlantBlueprint::drawBark(const TubeMesh& _mesh, const std::vector<GLsizei>& _counts, const std::vector<const GLvoid*>& _offsets)
+{
+	_mesh.drawRanges(_counts, _offsets);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void PlantBlueprint::drawLeaves(const InstanceBuffer& _instances)
+{
+	_instances.draw();
+}
+//----------------------------------------------------------------------------------------------------------------------
+void PlantBlueprint::drawLeaves(const InstanceBuffer& _instances, const std::vector<std::pair<unsigned, unsigned>>& _ranges)
+{
+	for (const auto& r : _ranges)
+	{
+		_instances.drawRange(r.first, r.second);
+	}
 }
 //----------------------------------------------------------------------------------------------------------------------
 void PlantBlueprint::setAxiom(const std::string _axiom)
@@ -101,6 +148,23 @@ void PlantBlueprint::setAxiom(const std::string _axiom)
 	//Otherwise set the axiom as the input
 	else
 		m_axiom = _axiom;
+
+	//The axiom parameters are constants, e.g. FFA(5)
+	if (!m_alphabet.encode(m_axiom, m_axiomModules))
+	{
+		std::cerr << "Invalid axiom " << m_axiom << "\n";
+		m_axiomModules.clear();
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
+void PlantBlueprint::setStreamDerivation(bool _isStreamed)
+{
+	if (_isStreamed && !Derivation::canStream(m_ruleTable))
+	{
+		std::cerr << "Grammar can't be streamed, as it has contexts or predecessors longer than one module\n";
+		_isStreamed = false;
+	}
+	m_streamDerivation = _isStreamed;
 }
 //----------------------------------------------------------------------------------------------------------------------
 void PlantBlueprint::readGrammarFromFile(const std::string _filePath)
@@ -108,14 +172,22 @@ void PlantBlueprint::readGrammarFromFile(const std::string _filePath)
 	std::ifstream fileIn(_filePath);//Open the file
 	std::string line;//Temp string for each line
 
-	//Set regular expressions for valid characters/numbers
-	const QString validCharacters = "([A-Z]|[" + QRegularExpression::escape("+-/\\\\&^") + "]|(\\[)|(\\]))+";
+	//Set regular expressions for valid characters, each optionally followed by bracketed parameters
+	const QString validCharacters = "(([A-Z]|[" + QRegularExpression::escape("+-/\\&^") + "]|(\\[)|(\\]))(\\(.+?\\))?)+";
 
-	//Set regular expressions using the format "predecessor=successor,probability" or "predecessor=successor"
-	const QString ruleString = "^(?<predecessor>" + validCharacters + ")\\=(?<successor>" + validCharacters + ")$";
+	//Set regular expressions using the format "left<predecessor>right:condition=successor,probability" or "predecessor=successor"
+	//A condition that contains = has to use -> instead, e.g. "A(t):t>=1->F(t)A(t-1)"
+	const QString probability = "(,(?<probability>[0-9]*\\.?[0-9]+))?";
+	const QString predecessor = "^((?<left>" + validCharacters + ")<)?(?<predecessor>" + validCharacters + ")(>(?<right>" + validCharacters + "))?";
+	const QString arrowRuleString = predecessor + "(:(?<condition>.+))?->(?<successor>" + validCharacters + ")" + probability + "$";
+	const QString ruleString = predecessor + "(:(?<condition>[^=]+))?\\=(?<successor>" + validCharacters + ")" + probability + "$";
+	//The symbols skipped when matching contexts, e.g. "#ignore:+-/"
+	const QString ignoreString = "^#ignore:(?<ignored>.+)$";
 
 	//Create the regular expressions
+	QRegularExpression arrowRule(arrowRuleString);
 	QRegularExpression rule(ruleString);
+	QRegularExpression ignore(ignoreString);
 
 	//Add the rules, one line at a time
 	while (std::getline(fileIn,line))
@@ -123,21 +195,40 @@ void PlantBlueprint::readGrammarFromFile(const std::string _filePath)
 		//Remove whitespaces
 		line.erase(std::remove(line.begin(),line.end(),' '),line.end());
 
+		QString qLine = QString::fromStdString(line);
+		QRegularExpressionMatch ignoreMatch = ignore.match(qLine);
+		if (ignoreMatch.hasMatch())
+		{
+			for (char c : ignoreMatch.captured("ignored").toStdString()) m_alphabet.setIgnored(m_alphabet.symbol(c));
+			continue;
+		}
+
 		//Create variables for adding to the container
 		std::string predecessorValue;
+		std::string leftValue;
+		std::string rightValue;
 		std::string successorValue;
+		std::string conditionValue;
+		float probabilityValue = -1.0f;
 
 		//Use expression matching to split the string
-		QString qLine = QString::fromStdString(line);
-		//Check for rule with probability
-		QRegularExpressionMatch match = rule.match(qLine);
+		QRegularExpressionMatch match = arrowRule.match(qLine);
+		if (!match.hasMatch()) match = rule.match(qLine);
 		if (match.hasMatch())
 		{
 			predecessorValue = match.captured("predecessor").toStdString();
+			leftValue = match.captured("left").toStdString();
+			rightValue = match.captured("right").toStdString();
 			successorValue = match.captured("successor").toStdString();
+			conditionValue = match.captured("condition").toStdString();
+			//Check for rule with probability
+			if (!match.captured("probability").isEmpty()) probabilityValue = match.captured("probability").toFloat();
 		}
 		//Construct the rule in the container
-		m_productionRules.emplace_back(predecessorValue,successorValue);
+		m_productionRules.emplace_back(predecessorValue,successorValue,conditionValue,probabilityValue,leftValue,rightValue);
 	}
+
+	//Compile the rules for rewriting
+	m_ruleTable.build(m_productionRules, m_alphabet);
 }
 //----------------------------------------------------------------------------------------------------------------------
@@ -35,8 +35,8 @@ PlantBlueprintDialog::PlantBlueprintDialog(QWidget *parent) :
 
 	//Add a validator for the L-system axiom
 	//Manual nested branches are used as it is difficult to implement with regular expressions. This uses a maximum of 3 nested branches
-	//This checks for empty brackets and bracket completion
-	const QString validCharacters = "([A-Z]*[" + QRegularExpression::escape("+-/\\\\&^") + "]*)*";
+	//This checks for empty brackets and bracket completion. Each symbol can have constant parameters, e.g. A(5,0.5)
+	const QString validCharacters = "(([A-Z]|[" + QRegularExpression::escape("+-/\\\\&^") + "])(\\([0-9.,\\-]+\\))?)*";
 	const QString branch = "(\\[(" + validCharacters + ")+\\])*";
 	const QString nest2 = "(\\[(" + validCharacters + branch + ")+\\])*";
 	const QString nest3 = "(\\[(" + validCharacters + nest2 + ")+\\])*";
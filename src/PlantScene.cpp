@@ -1,108 +1,54 @@
+#include <algorithm>
 #include <QMouseEvent>
 #include <QGuiApplication>
-#include <ngl/NGLInit.h>
-#include <ngl/ShaderLib.h>
-#include <ngl/VAOPrimitives.h>
+#include <QFontDatabase>
+#include <QPainter>
 #include "PlantScene.h"
-#include "PlantBlueprint.h"
 //----------------------------------------------------------------------------------------------------------------------
-PlantScene::PlantScene(QWidget *_parent) : QOpenGLWidget(_parent)
+PlantScene::PlantScene(QWidget *_parent) :
+	QOpenGLWidget(_parent),
+	m_renderer(new SceneRenderer)
 {
 	// re-size the widget to that of the parent (in this case the GLFrame passed in on construction)
 	setFocus();
 	this->resize(_parent->size());
-	initialisePresets();
+	SceneRenderer::initialisePresets();
 }
 //----------------------------------------------------------------------------------------------------------------------
-PlantScene::~PlantScene(){}
-//----------------------------------------------------------------------------------------------------------------------
-void PlantScene::initialisePresets()
+PlantScene::~PlantScene()
 {
-	//Rigid L-system. This has no space colonisation or tropisms
-	{
-		PlantBlueprint *pb = PlantBlueprint::instance("LSystemClone");
-		pb->setAxiom("FFA");
-		pb->readGrammarFromFile("presets/LSystemClone.txt");
-		pb->setDecay(1.5f);
-		pb->setDrawAngle(45);
-		pb->setDrawLength(0.7f);
-		pb->setMaxDepth(5);
-		pb->setMaxDeviation(0.0f);
-		pb->setLeavesPerBranch(30);
-		pb->setLeavesStartDepth(2);
-		pb->setLeafScale(0.05f);
-		pb->setControlPointsPerBranch(2);
-		pb->setRootRadius(0.1f);
-		pb->setPhototropismScaleFactor(0.00f);
-		pb->setGravitropismScaleFactor(0.0f);
-	}
-
-	//Tangled growth
-	{
-		PlantBlueprint *pb = PlantBlueprint::instance("TangledBranches");
-		pb->setAxiom("FA");
-		pb->readGrammarFromFile("presets/TangledBranches.txt");
-		pb->setDecay(1.4f);
-		pb->setDrawAngle(30);
-		pb->setDrawLength(0.8f);
-		pb->setMaxDepth(4);
-		pb->setMaxDeviation(0.1f);
-		pb->setLeavesPerBranch(0);
-		pb->setLeavesStartDepth(0);
-		pb->setLeafScale(0.03f);
-		pb->setControlPointsPerBranch(8);
-		pb->setRootRadius(0.05f);
-		pb->setPhototropismScaleFactor(0.0f);
-		pb->setGravitropismScaleFactor(0.0f);
-	}
-
-	//Generic tree
-	{
-		PlantBlueprint *pb = PlantBlueprint::instance("GenericTree");
-		pb->setAxiom("FFA");
-		pb->readGrammarFromFile("presets/GenericTree.txt");
-		pb->setDecay(1.4f);
-		pb->setDrawAngle(45);
-		pb->setDrawLength(1.2f);
-		pb->setMaxDepth(5);
-		pb->setMaxDeviation(0.1f);
-		pb->setLeavesPerBranch(30);
-		pb->setLeavesStartDepth(3);
-		pb->setLeafScale(0.03f);
-		pb->setControlPointsPerBranch(6);
-		pb->setRootRadius(0.04f);
-		pb->setPhototropismScaleFactor(0.005f);
-		pb->setGravitropismScaleFactor(0.0f);
-	}
+	//The plants own GL buffers, so they need the context to be current when deleted
+	makeCurrent();
+	m_renderer.reset();
+	doneCurrent();
 }
 //----------------------------------------------------------------------------------------------------------------------
 void PlantScene::updatePlants()
 {
 	//Update all plant simulations
-	for (Plant &p : m_plants)
-	{
-		p.updateSimulation();
-	}
+	m_renderer->updatePlants();
 	//Force a window update
 	update();
 }
 //----------------------------------------------------------------------------------------------------------------------
 void PlantScene::createPlant(std::string _type, float _x, float _z)
 {
-	ngl::Vec3 pos(_x,0.0f,_z);
-	m_plants.emplace_back(_type, pos);
+	m_renderer->createPlant(_type, _x, _z);
 	update();
 }
 //----------------------------------------------------------------------------------------------------------------------
 void PlantScene::setPlantVisibility(unsigned _index, bool _state)
 {
-	m_plants[_index].setVisibility(_state);
+	m_renderer->setPlantVisibility(_index, _state);
 	update();
 }
 //----------------------------------------------------------------------------------------------------------------------
 void PlantScene::deletePlant(unsigned _index)
 {
-	m_plants.erase(m_plants.begin() + _index);
+	//The plant owns GL buffers, so the context needs to be current when it is deleted
+	makeCurrent();
+	m_renderer->deletePlant(_index);
+	doneCurrent();
 	update();
 }
 //----------------------------------------------------------------------------------------------------------------------
@@ -115,82 +61,62 @@ void PlantScene::resizeGL(int _w , int _h)
 void PlantScene::initializeGL()
 {
 	QWidget::setFocusPolicy(Qt::StrongFocus);//Set keyboard focus
-	ngl::NGLInit::instance();//Initialise the ngl library
-	glClearColor(0.57f, 0.77f, 0.92f, 1.0f);// Light blue background
-	// enable depth testing for drawing
-	glEnable(GL_DEPTH_TEST);
-	// enable multisampling for smoother drawing
-	glEnable(GL_MULTISAMPLE);
-
-	// enable face culling
-	glEnable(GL_CULL_FACE);
-	glCullFace(GL_CW);
-
-	//Initialise the PlantBlueprint. This initialises the shader and the geometry needed for drawing
-	PlantBlueprint::init();
+	m_renderer->initGL();
 
 	//Initialise the camera
 	m_camera.set(ngl::Vec3(0.0f, 0.5f, 3.0f),//from
 							 ngl::Vec3(0.0f, 0.5f, 0.0f),//to
 							 ngl::Vec3::up());//up
 	m_camera.setShape(45, static_cast<float>(width())/height(), 0.001f, 60.0f);
-
-	//Send the viewer position to the shader
-	ngl::ShaderLib *shader = ngl::ShaderLib::instance();
-	shader->setUniform("viewerPos", m_camera.getEye().toVec3());
-
-	glViewport(0,0,width(),height());
-
-	//Create the ground plane geometry
-	ngl::VAOPrimitives::instance()->createTrianglePlane("groundPlane", 100, 100, 1, 1, ngl::Vec3::up());
-
-	//Initialise the texture for the ground
-	ngl::Texture groundTexture("textures/GroundTexture.jpg");
-	m_groundTexture = groundTexture.setTextureGL();
-	//Make the texture tileable
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 }
 //----------------------------------------------------------------------------------------------------------------------
-void PlantScene::drawScene()
+void PlantScene::paintGL()
 {
-	//Calculate the matrices for the ground plane
-	ngl::ShaderLib *shader = ngl::ShaderLib::instance();
-	ngl::Mat4 M;
-	ngl::Mat4 MV = M * m_camera.getViewMatrix();
-	ngl::Mat4 MVP = MV * m_camera.getProjectionMatrix();
-	ngl::Mat3 N = MV;
-	N.inverse();
-
-	//Send the matrices to the shader
-	shader->setUniform("M", M);
-	shader->setUniform("MV", MV);
-	shader->setUniform("MVP", MVP);
-	shader->setUniform("N", N);
-
-	//Set the texture scale as it needs to tile
-	shader->setUniform("texScale", 100.0f);
-
-	//Bind the texture for the ground plane
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, m_groundTexture);
-
-	//Draw the ground plane
-	ngl::VAOPrimitives::instance()->draw("groundPlane");
+	//QOpenGLWidget draws to its own framebuffer object rather than framebuffer 0
+	m_renderer->render(m_camera, defaultFramebufferObject(), width(), height());
 
-	//Draw the plants if visible
-	for (Plant &p : m_plants)
+	if (m_showStats)
 	{
-		if (p.visibility()) p.draw(m_camera.getViewMatrix(), m_camera.getProjectionMatrix());
+		drawStatsOverlay();
+		//Keep drawing so the statistics are measured every frame
+		update();
 	}
 }
 //----------------------------------------------------------------------------------------------------------------------
-void PlantScene::paintGL()
+void PlantScene::drawStatsOverlay()
 {
-	// clear the screen and depth buffer
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	glViewport(0,0,width(),height());
-	drawScene();	//Draw the ground plane then call each Plant draw call
+	//The GPU times are a few frames behind, so show the latest frame that has them
+	const FrameRecord& r = m_renderer->stats().latest();
+	double cpuTotal = 0.0;
+	double gpuTotal = 0.0;
+	QStringList lines;
+	lines << QString("%1 %2 %3").arg("phase", -10).arg("cpu ms", 8).arg("gpu ms", 8);
+	for (unsigned p=0; p<FrameRecord::s_phaseCount; ++p)
+	{
+		lines << QString("%1 %2 %3").arg(FrameStats::phaseName(p), -10).arg(r.m_cpuTime[p], 8, 'f', 2).arg(r.m_gpuTime[p], 8, 'f', 2);
+		cpuTotal += r.m_cpuTime[p];
+		gpuTotal += r.m_gpuTime[p];
+	}
+	lines << QString("%1 %2 %3").arg("total", -10).arg(cpuTotal, 8, 'f', 2).arg(gpuTotal, 8, 'f', 2);
+	lines << QString("draw calls %1").arg(r.m_drawCalls);
+	lines << QString("triangles  %1").arg(r.m_triangles);
+	lines << QString("instances  %1").arg(r.m_instances);
+
+	//Draw the text on a translucent background in the top left corner
+	QPainter painter(this);
+	painter.setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+	painter.setRenderHint(QPainter::TextAntialiasing);
+	QFontMetrics metrics = painter.fontMetrics();
+	int lineHeight = metrics.height();
+	int boxWidth = 0;
+	for (const QString& l : lines) boxWidth = std::max(boxWidth, metrics.width(l));
+	painter.fillRect(4, 4, boxWidth + 8, lineHeight * lines.size() + 8, QColor(0, 0, 0, 160));
+	painter.setPen(Qt::white);
+	for (int i=0; i<lines.size(); ++i)
+	{
+		painter.drawText(8, 8 + metrics.ascent() + i * lineHeight, lines[i]);
+	}
+	painter.end();
 }
 //----------------------------------------------------------------------------------------------------------------------
 void PlantScene::keyPressEvent(QKeyEvent *_event)
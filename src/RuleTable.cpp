@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <map>
+#include <utility>
+#include "RuleTable.h"
+//----------------------------------------------------------------------------------------------------------------------
+constexpr unsigned RuleTable::s_none;
+//----------------------------------------------------------------------------------------------------------------------
+RuleTable::RuleTable()
+{
+	m_nodes.push_back({0, 0, s_none, 0, 0});
+	m_rootNodes.fill(s_none);
+	m_expansion.fill(1);
+	m_hasContextRules = false;
+	m_longestPredecessor = 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void RuleTable::build(const std::vector<ProductionRule>& _rules, Alphabet& _alphabet)
+{
+	m_rules.clear();
+	m_nodeRules.clear();
+	m_nodes.clear();
+	m_edges.clear();
+	m_rootNodes.fill(s_none);
+	m_expansion.fill(1);
+	m_hasContextRules = false;
+	m_longestPredecessor = 0;
+
+	//The stochastic rules by contexts, predecessor and condition, with the weight of each successor
+	std::map<std::string, unsigned> stochasticRules;
+	std::vector<std::vector<float>> weights;
+
+	for (const ProductionRule& r : _rules)
+	{
+		if (r.m_predecessor.empty()) continue;
+		Rule compiled;
+		if (!compile(r, _alphabet, compiled))
+		{
+			std::cerr << "Skipping invalid rule " << r.m_leftContext << (r.m_leftContext.empty() ? "" : "<") << r.m_predecessor << (r.m_rightContext.empty() ? "" : ">") << r.m_rightContext << (r.m_condition.empty() ? "" : ":") << r.m_condition << "=" << r.m_successor << "\n";
+			continue;
+		}
+
+		//Add the successor of a stochastic rule to the first rule with the same contexts, predecessor and condition
+		if (r.m_probability >= 0.0f)
+		{
+			std::string key = r.m_leftContext + "<" + r.m_predecessor + ">" + r.m_rightContext + ":" + r.m_condition;
+			auto it = stochasticRules.emplace(key, static_cast<unsigned>(m_rules.size())).first;
+			if (it->second < m_rules.size())
+			{
+				m_rules[it->second].m_successors.push_back(std::move(compiled.m_successors[0]));
+				weights[it->second].push_back(r.m_probability);
+				continue;
+			}
+		}
+		m_hasContextRules = m_hasContextRules || compiled.m_hasContext;
+		m_longestPredecessor = std::max(m_longestPredecessor, compiled.m_predecessor.size());
+		m_rules.push_back(std::move(compiled));
+		weights.push_back({r.m_probability});
+	}
+	for (unsigned i=0; i<m_rules.size(); ++i)
+	{
+		if (m_rules[i].m_successors.size() > 1) m_rules[i].m_successorTable.build(weights[i]);
+	}
+
+	//Insert the predecessors. The children are kept in maps while building so they come out sorted
+	std::vector<std::map<uint8_t, unsigned>> children(1);
+	std::vector<std::vector<unsigned>> nodeRules(1);
+	for (unsigned i=0; i<m_rules.size(); ++i)
+	{
+		unsigned node = 0;
+		for (uint8_t symbol : m_rules[i].m_predecessor.symbols())
+		{
+			auto it = children[node].find(symbol);
+			if (it == children[node].end())
+			{
+				it = children[node].emplace(symbol, static_cast<unsigned>(children.size())).first;
+				children.emplace_back();
+				nodeRules.emplace_back();
+			}
+			node = it->second;
+		}
+		nodeRules[node].push_back(i);
+	}
+
+	//Children come after their parent, so a reverse pass sees every child before its parent
+	m_nodes.resize(children.size());
+	for (std::size_t n=m_nodes.size(); n-- > 0;)
+	{
+		Node& node = m_nodes[n];
+		node.m_firstRule = nodeRules[n].empty() ? s_none : nodeRules[n].front();
+		for (const auto& c : children[n])
+		{
+			node.m_firstRule = std::min(node.m_firstRule, m_nodes[c.second].m_firstRule);
+		}
+	}
+
+	//Flatten the children and rules into contiguous arrays
+	for (std::size_t n=0; n<m_nodes.size(); ++n)
+	{
+		m_nodes[n].m_firstNodeRule = static_cast<unsigned>(m_nodeRules.size());
+		m_nodes[n].m_nodeRuleCount = static_cast<unsigned>(nodeRules[n].size());
+		m_nodeRules.insert(m_nodeRules.end(), nodeRules[n].begin(), nodeRules[n].end());
+
+		m_nodes[n].m_firstEdge = static_cast<unsigned>(m_edges.size());
+		m_nodes[n].m_edgeCount = static_cast<unsigned>(children[n].size());
+		for (const auto& c : children[n])
+		{
+			m_edges.push_back({c.first, c.second});
+		}
+	}
+	for (const auto& c : children[0])
+	{
+		m_rootNodes[c.first] = c.second;
+	}
+
+	//A rule with a single symbol predecessor, no context and no condition always matches, so the rules after it are never applied
+	for (std::size_t s=0; s<s_symbolCount; ++s)
+	{
+		if (m_rootNodes[s] == s_none) continue;
+		unsigned firstRule = m_nodes[m_rootNodes[s]].m_firstRule;
+		for (unsigned i=firstRule; i<m_rules.size(); ++i)
+		{
+			if (m_rules[i].m_predecessor[0] != s) continue;
+			std::size_t longest = 0;
+			for (const Successor& successor : m_rules[i].m_successors) longest = std::max(longest, successor.m_modules.size());
+			m_expansion[s] = std::max(m_expansion[s], longest);
+			if (m_rules[i].m_predecessor.size() == 1 && !m_rules[i].m_hasContext && !m_rules[i].m_hasCondition)
+			{
+				//If this is the first rule the symbol always expands to exactly this length
+				if (i == firstRule && m_rules[i].m_successors.size() == 1) m_expansion[s] = longest;
+				break;
+			}
+		}
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool RuleTable::compile(const ProductionRule& _rule, Alphabet& _alphabet, Rule& _compiled)
+{
+	std::vector<Alphabet::ModuleText> modules;
+	std::vector<std::string> names;
+
+	//The arguments of the contexts and predecessor are the names of the parameters, in the order they are written
+	auto readNames = [&](const std::string& _text, ModuleString& _modules)
+	{
+		if (!Alphabet::split(_text, modules)) return false;
+		for (const Alphabet::ModuleText& m : modules)
+		{
+			uint8_t symbol = _alphabet.symbol(m.m_character);
+			if (!_alphabet.useArity(symbol, static_cast<unsigned>(m.m_arguments.size()))) return false;
+			for (const std::string& a : m.m_arguments)
+			{
+				bool isName = std::isalpha(static_cast<unsigned char>(a[0])) || a[0] == '_';
+				for (char c : a) isName = isName && (std::isalnum(static_cast<unsigned char>(c)) || c == '_');
+				if (!isName) return false;
+				names.push_back(a);
+			}
+			_modules.append(symbol);
+		}
+		return true;
+	};
+	if (!readNames(_rule.m_leftContext, _compiled.m_leftContext)) return false;
+	std::size_t firstPredecessorName = names.size();
+	if (!readNames(_rule.m_predecessor, _compiled.m_predecessor)) return false;
+	_compiled.m_predecessorParameterCount = static_cast<unsigned>(names.size() - firstPredecessorName);
+	if (!readNames(_rule.m_rightContext, _compiled.m_rightContext)) return false;
+
+	//Brackets can't be context, since the neighbours skip over them
+	_compiled.m_hasContext = !_compiled.m_leftContext.empty() || !_compiled.m_rightContext.empty();
+	if (_compiled.m_leftContext.size() > s_maxContextLength || _compiled.m_rightContext.size() > s_maxContextLength) return false;
+	for (const ModuleString* c : {&_compiled.m_leftContext, &_compiled.m_rightContext})
+	{
+		for (uint8_t s : c->symbols())
+		{
+			if (Alphabet::isBracket(s)) return false;
+		}
+	}
+
+	_compiled.m_hasCondition = !_rule.m_condition.empty();
+	if (_compiled.m_hasCondition && !_compiled.m_condition.compile(_rule.m_condition, names)) return false;
+
+	//The successor arguments are expressions, which are evaluated when the rule is applied
+	if (!Alphabet::split(_rule.m_successor, modules)) return false;
+	_compiled.m_successors.emplace_back();
+	Successor& successor = _compiled.m_successors.back();
+	std::vector<float> placeholders;
+	for (const Alphabet::ModuleText& m : modules)
+	{
+		uint8_t symbol = _alphabet.symbol(m.m_character);
+		if (!_alphabet.useArity(symbol, static_cast<unsigned>(m.m_arguments.size()))) return false;
+		for (const std::string& a : m.m_arguments)
+		{
+			successor.m_parameters.emplace_back();
+			if (!successor.m_parameters.back().compile(a, names)) return false;
+		}
+		placeholders.assign(m.m_arguments.size(), 0.0f);
+		successor.m_modules.append(symbol, placeholders.data(), placeholders.size());
+	}
+	successor.m_branchCount = successor.m_modules.count(Alphabet::PUSH);
+	successor.m_drawCount = successor.m_modules.count(Alphabet::DRAW);
+	return true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+RuleTable::Match RuleTable::match(const ModuleString& _modules, std::size_t _position, std::size_t _firstParameter, const ContextIndex* _context, std::vector<float>& _contextParameters) const
+{
+	//The parameters of the modules the predecessor covers are contiguous, so they are the parameters of a rule without context
+	const float* parameters = _modules.parameters().data() + _firstParameter;
+
+	unsigned best = s_none;
+	std::size_t bestEnd = _position;
+	std::size_t end = _position;
+	unsigned node = m_rootNodes[_modules[_position]];
+	while (node != s_none)
+	{
+		const Node& n = m_nodes[node];
+		++end;
+		//Stop if no rule further down would be applied before the best one so far
+		if (n.m_firstRule >= best) break;
+		for (unsigned i=n.m_firstNodeRule; i<n.m_firstNodeRule+n.m_nodeRuleCount; ++i)
+		{
+			unsigned r = m_nodeRules[i];
+			if (r >= best) break;
+			const Rule& rule = m_rules[r];
+			const float* ruleParameters = parameters;
+			if (rule.m_hasContext)
+			{
+				if (_context == nullptr || !matchContext(rule, _modules, _position, end, *_context, _contextParameters)) continue;
+				ruleParameters = _contextParameters.data();
+			}
+			if (!rule.m_hasCondition || rule.m_condition.evaluate(ruleParameters) != 0.0f)
+			{
+				best = r;
+				bestEnd = end;
+				break;
+			}
+		}
+		if (end == _modules.size()) break;
+		node = child(n, _modules[end]);
+	}
+	if (best == s_none) return {nullptr, parameters};
+
+	//A context sensitive rule tested after the best one may have overwritten its parameters
+	const Rule& rule = m_rules[best];
+	if (!rule.m_hasContext) return {&rule, parameters};
+	matchContext(rule, _modules, _position, bestEnd, *_context, _contextParameters);
+	return {&rule, _contextParameters.data()};
+}
+//----------------------------------------------------------------------------------------------------------------------
+const RuleTable::Successor& RuleTable::choose(const Rule& _rule, Philox& _random)
+{
+	if (_rule.m_successors.size() == 1) return _rule.m_successors[0];
+	float column = _random.generateFloat();
+	float coin = _random.generateFloat();
+	return _rule.m_successors[_rule.m_successorTable.sample(column, coin)];
+}
+//----------------------------------------------------------------------------------------------------------------------
+void RuleTable::apply(const Successor& _successor, const float* _parameters, ModuleString& _modules)
+{
+	std::size_t firstParameter = _modules.parameters().size();
+	_modules.append(_successor.m_modules);
+	for (std::size_t i=0; i<_successor.m_parameters.size(); ++i)
+	{
+		_modules.setParameter(firstParameter + i, _successor.m_parameters[i].evaluate(_parameters));
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
+std::size_t RuleTable::rewrittenLength(const ModuleString& _modules) const
+{
+	std::size_t length = 0;
+	for (uint8_t s : _modules.symbols())
+	{
+		length += m_expansion[s];
+	}
+	return length;
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool RuleTable::matchContext(const Rule& _rule, const ModuleString& _modules, std::size_t _position, std::size_t _end, const ContextIndex& _context, std::vector<float>& _parameters)
+{
+	//Walk left from the predecessor, matching the left context from its last module
+	std::array<uint32_t, s_maxContextLength> left;
+	uint32_t neighbour = static_cast<uint32_t>(_position);
+	for (std::size_t i=_rule.m_leftContext.size(); i-- > 0;)
+	{
+		neighbour = _context.left(neighbour);
+		if (neighbour == ContextIndex::s_none || _modules[neighbour] != _rule.m_leftContext[i]) return false;
+		left[i] = neighbour;
+	}
+	std::array<uint32_t, s_maxContextLength> right;
+	neighbour = static_cast<uint32_t>(_end - 1);
+	for (std::size_t i=0; i<_rule.m_rightContext.size(); ++i)
+	{
+		neighbour = _context.right(neighbour);
+		if (neighbour == ContextIndex::s_none || _modules[neighbour] != _rule.m_rightContext[i]) return false;
+		right[i] = neighbour;
+	}
+
+	//Gather the parameters in the order they are named
+	const float* parameters = _modules.parameters().data();
+	auto gather = [&](std::size_t _begin, std::size_t _count)
+	{
+		_parameters.insert(_parameters.end(), parameters + _begin, parameters + _begin + _count);
+	};
+	_parameters.clear();
+	for (std::size_t i=0; i<_rule.m_leftContext.size(); ++i)
+	{
+		gather(_context.firstParameter(left[i]), _context.firstParameter(left[i] + 1) - _context.firstParameter(left[i]));
+	}
+	gather(_context.firstParameter(_position), _rule.m_predecessorParameterCount);
+	for (std::size_t i=0; i<_rule.m_rightContext.size(); ++i)
+	{
+		gather(_context.firstParameter(right[i]), _context.firstParameter(right[i] + 1) - _context.firstParameter(right[i]));
+	}
+	return true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+unsigned RuleTable::child(const Node& _node, uint8_t _symbol) const
+{
+	auto begin = m_edges.begin() + _node.m_firstEdge;
+	auto end = begin + _node.m_edgeCount;
+	auto it = std::lower_bound(begin, end, _symbol, [](const Edge& _edge, uint8_t _s){return _edge.m_symbol < _s;});
+	return (it != end && it->m_symbol == _symbol) ? it->m_node : s_none;
+}
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,219 @@
+#include <ngl/NGLInit.h>
+#include <ngl/ShaderLib.h>
+#include <ngl/Texture.h>
+#include <ngl/VAOPrimitives.h>
+#include "SceneRenderer.h"
+#include "PlantBlueprint.h"
+//----------------------------------------------------------------------------------------------------------------------
+const std::string SceneRenderer::s_groundShaderProgramName = "Ground";
+//----------------------------------------------------------------------------------------------------------------------
+void SceneRenderer::initialisePresets()
+{
+	//Rigid L-system. This has no space colonisation or tropisms
+	{
+		PlantBlueprint *pb = PlantBlueprint::instance("LSystemClone");
+		pb->setAxiom("FFA");
+		pb->readGrammarFromFile("presets/LSystemClone.txt");
+		pb->setDecay(1.5f);
+		pb->setDrawAngle(45);
+		pb->setDrawLength(0.7f);
+		pb->setMaxDepth(5);
+		pb->setMaxDeviation(0.0f);
+		pb->setLeavesPerBranch(30);
+		pb->setLeavesStartDepth(2);
+		pb->setLeafScale(0.05f);
+		pb->setControlPointsPerBranch(2);
+		pb->setRootRadius(0.1f);
+		pb->setPhototropismScaleFactor(0.00f);
+		pb->setGravitropismScaleFactor(0.0f);
+	}
+
+	//Tangled growth
+	{
+		PlantBlueprint *pb = PlantBlueprint::instance("TangledBranches");
+		pb->setAxiom("FA");
+		pb->readGrammarFromFile("presets/TangledBranches.txt");
+		pb->setDecay(1.4f);
+		pb->setDrawAngle(30);
+		pb->setDrawLength(0.8f);
+		pb->setMaxDepth(4);
+		pb->setMaxDeviation(0.1f);
+		pb->setLeavesPerBranch(0);
+		pb->setLeavesStartDepth(0);
+		pb->setLeafScale(0.03f);
+		pb->setControlPointsPerBranch(8);
+		pb->setRootRadius(0.05f);
+		pb->setPhototropismScaleFactor(0.0f);
+		pb->setGravitropismScaleFactor(0.0f);
+	}
+
+	//Generic tree
+	{
+		PlantBlueprint *pb = PlantBlueprint::instance("GenericTree");
+		pb->setAxiom("FFA");
+		pb->readGrammarFromFile("presets/GenericTree.txt");
+		pb->setDecay(1.4f);
+		pb->setDrawAngle(45);
+		pb->setDrawLength(1.2f);
+		pb->setMaxDepth(5);
+		pb->setMaxDeviation(0.1f);
+		pb->setLeavesPerBranch(30);
+		pb->setLeavesStartDepth(3);
+		pb->setLeafScale(0.03f);
+		pb->setControlPointsPerBranch(6);
+		pb->setRootRadius(0.04f);
+		pb->setPhototropismScaleFactor(0.005f);
+		pb->setGravitropismScaleFactor(0.0f);
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
+void SceneRenderer::initGL()
+{
+	ngl::NGLInit::instance();//Initialise the ngl library
+	setGLState();
+
+	//Initialise the PlantBlueprint. This initialises the shader and the geometry needed for drawing
+	PlantBlueprint::init();
+	//Create the impostor atlas. This needs the leaf geometry from the PlantBlueprint
+	m_impostors.reset(new ImpostorAtlas);
+
+	//Create the ground plane geometry
+	ngl::VAOPrimitives::instance()->createTrianglePlane("groundPlane", 100, 100, 1, 1, ngl::Vec3::up());
+	//The ground is opaque like the bark, but the texture tiles. The tile factor and the model matrix never change
+	ngl::ShaderLib *shader = ngl::ShaderLib::instance();
+	shader->createShaderProgram(s_groundShaderProgramName);
+	shader->loadShader(s_groundShaderProgramName, "shaders/BlinnPhong.vertex.glsl", "shaders/BlinnPhong.fragment.glsl");
+	(*shader)[s_groundShaderProgramName]->use();
+	shader->setUniform("M", ngl::Mat4());
+	shader->setUniform("texScale", 100.0f);
+
+	//Initialise the texture for the ground
+	ngl::Texture groundTexture("textures/GroundTexture.jpg");
+	m_groundTexture = groundTexture.setTextureGL();
+	//Make the texture tileable
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void SceneRenderer::setGLState()
+{
+	glClearColor(0.57f, 0.77f, 0.92f, 1.0f);// Light blue background
+	// enable depth testing for drawing
+	glEnable(GL_DEPTH_TEST);
+	glDepthMask(GL_TRUE);
+	// enable multisampling for smoother drawing
+	glEnable(GL_MULTISAMPLE);
+	glDisable(GL_BLEND);
+
+	// enable face culling
+	glEnable(GL_CULL_FACE);
+	glCullFace(GL_CW);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void SceneRenderer::render(const ngl::Camera& _camera, GLuint _framebuffer, int _width, int _height)
+{
+	m_stats.beginFrame();
+	m_stats.beginPhase(FrameStats::SETUP);
+
+	//Overlays drawn with QPainter change the state, so it is set again every frame
+	setGLState();
+
+	// clear the screen and depth buffer
+	glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	glViewport(0, 0, _width, _height);
+
+	drawScene(_camera, _framebuffer);	//Draw the ground plane then call each Plant draw call
+	m_stats.endFrame();
+}
+//----------------------------------------------------------------------------------------------------------------------
+void SceneRenderer::drawScene(const ngl::Camera& _camera, GLuint _framebuffer)
+{
+	const ngl::Mat4& view = _camera.getViewMatrix();
+	const ngl::Mat4& projection = _camera.getProjectionMatrix();
+	ngl::Vec3 eye = _camera.getEye().toVec3();
+
+	//Choose how each plant is drawn before anything is drawn, as capturing impostors changes the shader state.
+	//Each plant culls itself and its branches against the frustum
+	Frustum frustum(view * projection);
+	m_impostors->clear();
+	m_visiblePlants.clear();
+	unsigned captures = 0;
+	for (Plant &p : m_plants)
+	{
+		if (!p.visibility()) continue;
+		p.updateLOD(eye, m_impostorDistance);
+
+		//Distant plants are queued as impostors, capturing them first if they have changed
+		if (p.isImpostor() && frustum.test(p.bounds()) != Frustum::OUTSIDE)
+		{
+			if (!m_impostors->isCurrent(p.impostor()) && captures < s_impostorCapturesPerFrame)
+			{
+				m_impostors->capture(p, _framebuffer);
+				++captures;
+			}
+			if (m_impostors->isCurrent(p.impostor()))
+			{
+				m_impostors->add(p);
+				continue;
+			}
+		}
+		if (p.prepareDraw(frustum)) m_visiblePlants.push_back(&p);
+	}
+	m_stats.endPhase();
+
+	//Draw the ground plane. The plane is a single quad
+	m_stats.beginPhase(FrameStats::GROUND);
+	ngl::ShaderLib *shader = ngl::ShaderLib::instance();
+	(*shader)[s_groundShaderProgramName]->use();
+	ngl::Mat3 N = view;
+	N.inverse();
+	shader->setUniform("MV", view);
+	shader->setUniform("MVP", view * projection);
+	shader->setUniform("N", N);
+	shader->setUniform("viewerPos", eye);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, m_groundTexture);
+	ngl::VAOPrimitives::instance()->draw("groundPlane");
+	FrameStats::recordDraw(2);
+	m_stats.endPhase();
+
+	//Draw the plants sorted by shader, so the opaque bark shader and the alpha tested leaf shader are each bound once
+	m_stats.beginPhase(FrameStats::PLANTS);
+	PlantBlueprint::beginBarkPass(view, projection, eye);
+	for (const Plant* p : m_visiblePlants) p->drawBark();
+	PlantBlueprint::beginLeafPass(view, projection, eye);
+	for (const Plant* p : m_visiblePlants) p->drawLeaves();
+	PlantBlueprint::endLeafPass();
+	m_stats.endPhase();
+
+	//Draw all the impostors with one draw call
+	m_stats.beginPhase(FrameStats::IMPOSTORS);
+	m_impostors->draw(view, projection, eye);
+	m_stats.endPhase();
+}
+//----------------------------------------------------------------------------------------------------------------------
+void SceneRenderer::updatePlants()
+{
+	//Update all plant simulations. The plants are independent and the GL upload happens later while drawing,
+	//so they can be updated on any thread
+	m_threadPool.parallelFor(static_cast<unsigned>(m_plants.size()), [this](unsigned _i){m_plants[_i].updateSimulation();});
+}
+//----------------------------------------------------------------------------------------------------------------------
+void SceneRenderer::createPlant(const std::string& _type, float _x, float _z)
+{
+	ngl::Vec3 pos(_x,0.0f,_z);
+	m_plants.emplace_back(_type, pos);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void SceneRenderer::setPlantVisibility(unsigned _index, bool _state)
+{
+	m_plants[_index].setVisibility(_state);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void SceneRenderer::deletePlant(unsigned _index)
+{
+	if (m_impostors) m_impostors->release(m_plants[_index].impostor());
+	m_plants.erase(m_plants.begin() + _index);
+}
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include "ThreadPool.h"
+//----------------------------------------------------------------------------------------------------------------------
+ThreadPool::ThreadPool(unsigned _threadCount)
+{
+	//hardware_concurrency can return 0 if it is unknown
+	if (_threadCount == 0) _threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+	for (unsigned i=0; i<_threadCount; ++i)
+	{
+		m_ranges.emplace_back(new WorkRange);
+	}
+	for (unsigned i=1; i<_threadCount; ++i)
+	{
+		m_threads.emplace_back(&ThreadPool::workerLoop, this, i);
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isStopping = true;
+	}
+	m_wake.notify_all();
+	for (std::thread& t : m_threads)
+	{
+		t.join();
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
+void ThreadPool::parallelFor(unsigned _count, const std::function<void(unsigned)>& _function)
+{
+	//Not worth waking the threads
+	if (m_threads.empty() || _count < 2)
+	{
+		for (unsigned i=0; i<_count; ++i) _function(i);
+		return;
+	}
+
+	//Give each worker an even share to start with
+	unsigned workers = static_cast<unsigned>(m_ranges.size());
+	for (unsigned w=0; w<workers; ++w)
+	{
+		std::lock_guard<std::mutex> lock(m_ranges[w]->m_mutex);
+		m_ranges[w]->m_begin = static_cast<unsigned>(static_cast<unsigned long long>(_count) * w / workers);
+		m_ranges[w]->m_end = static_cast<unsigned>(static_cast<unsigned long long>(_count) * (w+1) / workers);
+	}
+
+	//Start the job
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_function = &_function;
+		m_busyThreads = static_cast<unsigned>(m_threads.size());
+		++m_job;
+	}
+	m_wake.notify_all();
+
+	//The calling thread is worker 0
+	work(0);
+
+	//Wait for the other threads, which may still be running stolen work
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_done.wait(lock, [this]{return m_busyThreads == 0;});
+	m_function = nullptr;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void ThreadPool::workerLoop(unsigned _worker)
+{
+	unsigned lastJob = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [&]{return m_isStopping || m_job != lastJob;});
+			if (m_isStopping) return;
+			lastJob = m_job;
+		}
+
+		work(_worker);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (--m_busyThreads == 0) m_done.notify_one();
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
+void ThreadPool::work(unsigned _worker)
+{
+	unsigned index;
+	while (pop(_worker, index) || steal(_worker, index))
+	{
+		(*m_function)(index);
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool ThreadPool::pop(unsigned _worker, unsigned& _index)
+{
+	WorkRange& range = *m_ranges[_worker];
+	std::lock_guard<std::mutex> lock(range.m_mutex);
+	if (range.m_begin == range.m_end) return false;
+	_index = range.m_begin++;
+	return true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool ThreadPool::steal(unsigned _worker, unsigned& _index)
+{
+	unsigned workers = static_cast<unsigned>(m_ranges.size());
+	for (unsigned i=1; i<workers; ++i)
+	{
+		unsigned begin, end;
+		//Take the second half of the victim's range. Only one lock is held at a time, so thieves can't deadlock
+		{
+			WorkRange& victim = *m_ranges[(_worker + i) % workers];
+			std::lock_guard<std::mutex> lock(victim.m_mutex);
+			if (victim.m_begin == victim.m_end) continue;
+			begin = victim.m_begin + (victim.m_end - victim.m_begin) / 2;
+			end = victim.m_end;
+			victim.m_end = begin;
+		}
+
+		//Do the first stolen index now and keep the rest, where it can be stolen again
+		_index = begin;
+		WorkRange& range = *m_ranges[_worker];
+		std::lock_guard<std::mutex> lock(range.m_mutex);
+		range.m_begin = begin + 1;
+		range.m_end = end;
+		return true;
+	}
+	return false;
+}
+//----------------------------------------------------------------------------------------------------------------------
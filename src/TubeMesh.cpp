@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cmath>
+#include <ngl/Util.h>
+#include "TubeMesh.h"
+#include "PlantGeometry.h"
+//----------------------------------------------------------------------------------------------------------------------
+TubeMesh::TubeMesh(unsigned _radialSegments) :
+	m_radialSegments(_radialSegments)
+{
+	//The last entry repeats the first so the texture seam has its own vertices
+	for (unsigned i=0; i<=m_radialSegments; ++i)
+	{
+		float theta = ngl::TWO_PI * i / m_radialSegments;
+		m_cosTable.push_back(cos(theta));
+		m_sinTable.push_back(sin(theta));
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
+ngl::Vec3 TubeMesh::perpendicular(const ngl::Vec3& _direction)
+{
+	//Cross with the axis least aligned with the direction to avoid a degenerate result
+	ngl::Vec3 axis = (fabs(_direction.m_y) < 0.9f) ? ngl::Vec3::up() : ngl::Vec3(1.0f, 0.0f, 0.0f);
+	ngl::Vec3 result = _direction.cross(axis);
+	result.normalize();
+	return result;
+}
+//----------------------------------------------------------------------------------------------------------------------
+unsigned TubeMesh::sweptNodeCount(unsigned _count, unsigned _stride)
+{
+	//A branch needs at least one segment
+	if (_count < 2) return 0;
+	//Every stride-th node up to the end, plus the end itself
+	unsigned step = _stride > 0 ? std::min(_stride, _count - 1) : _count - 1;
+	return (_count - 2) / step + 2;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void TubeMesh::addBranch(const PointArray& _nodes, unsigned _first, unsigned _count, unsigned _stride, float _radius)
+{
+	const unsigned nodeCount = sweptNodeCount(_count, _stride);
+	if (nodeCount == 0) return;
+
+	//Read the swept nodes from the coordinate arrays
+	const unsigned step = _stride > 0 ? std::min(_stride, _count - 1) : _count - 1;
+	const float* x = _nodes.x() + _first;
+	const float* y = _nodes.y() + _first;
+	const float* z = _nodes.z() + _first;
+	auto node = [&](unsigned _i)
+	{
+		unsigned n = std::min(_i * step, _count - 1);
+		return ngl::Vec3(x[n], y[n], z[n]);
+	};
+
+	const unsigned ringSize = m_radialSegments + 1;
+	const GLuint firstVertex = static_cast<GLuint>(m_vertices.size());
+
+	//Initialise the frame from the first segment
+	ngl::Vec3 previous = node(0);
+	ngl::Vec3 current = previous;
+	ngl::Vec3 next = node(1);
+	ngl::Vec3 tangent = next - current;
+	tangent.normalize();
+	ngl::Vec3 normal = perpendicular(tangent);
+	float distance = 0.0f;
+
+	for (unsigned i=0; i<nodeCount; ++i)
+	{
+		//Calculate the tangent at the node. Joints use the average of both segments so the ring bisects the bend
+		ngl::Vec3 incoming = current - previous;
+		ngl::Vec3 outgoing = (i+1 < nodeCount) ? next - current : ngl::Vec3(0.0f, 0.0f, 0.0f);
+		distance += incoming.length();
+		if (incoming.lengthSquared() > 0.0f) incoming.normalize();
+		if (outgoing.lengthSquared() > 0.0f) outgoing.normalize();
+		ngl::Vec3 nodeTangent = incoming + outgoing;
+		//Keep the previous tangent for zero length segments and hairpin bends
+		if (nodeTangent.lengthSquared() > 1e-6f)
+		{
+			nodeTangent.normalize();
+			tangent = nodeTangent;
+		}
+
+		//Parallel transport the normal so the ring doesn't twist along the branch
+		normal -= tangent * normal.dot(tangent);
+		if (normal.lengthSquared() > 1e-6f) normal.normalize();
+		else normal = perpendicular(tangent);
+		ngl::Vec3 binormal = tangent.cross(normal);
+
+		//Add the ring of vertices
+		float v = distance / (ngl::TWO_PI * _radius);
+		for (unsigned j=0; j<ringSize; ++j)
+		{
+			ngl::Vec3 offset = normal * m_cosTable[j] + binormal * m_sinTable[j];
+			m_vertices.emplace_back(current + offset * _radius, ngl::Vec2(static_cast<float>(j) / m_radialSegments, v), offset);
+		}
+
+		//Move along to the next node, reading each node once
+		previous = current;
+		current = next;
+		if (i+2 < nodeCount) next = node(i+2);
+	}
+
+	//Connect each ring to the next, counter clockwise when viewed from outside
+	for (unsigned i=0; i+1<nodeCount; ++i)
+	{
+		for (unsigned j=0; j<m_radialSegments; ++j)
+		{
+			GLuint a = firstVertex + i * ringSize + j;
+			GLuint b = a + ringSize;
+			m_indices.insert(m_indices.end(), {a, a+1, b, a+1, b+1, b});
+		}
+	}
+
+	//Close the tip with a fan. The base is hidden inside the parent branch or the ground
+	const GLuint lastRing = firstVertex + (nodeCount - 1) * ringSize;
+	const GLuint centre = static_cast<GLuint>(m_vertices.size());
+	m_vertices.emplace_back(current, ngl::Vec2(0.5f, distance / (ngl::TWO_PI * _radius)), tangent);
+	for (unsigned j=0; j<m_radialSegments; ++j)
+	{
+		m_indices.insert(m_indices.end(), {centre, lastRing+j, lastRing+j+1});
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
+void TubeMesh::reserve(std::size_t _nodeCount, std::size_t _branchCount)
+{
+	//Each node is a ring, each segment is a quad per radial segment and each branch has a tip fan
+	m_vertices.reserve(m_vertices.size() + _nodeCount * (m_radialSegments + 1) + _branchCount);
+	m_indices.reserve(m_indices.size() + ((_nodeCount - std::min(_nodeCount, _branchCount)) * 6 + _branchCount * 3) * m_radialSegments);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void TubeMesh::clear()
+{
+	m_vertices.clear();
+	m_indices.clear();
+	m_uploadedVertices = 0;
+	m_uploadedIndices = 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void TubeMesh::upload()
+{
+	m_mesh.appendData(m_vertices, m_indices, m_uploadedVertices, m_uploadedIndices);
+	m_uploadedVertices = m_vertices.size();
+	m_uploadedIndices = m_indices.size();
+}
+//----------------------------------------------------------------------------------------------------------------------
+void TubeMesh::draw() const
+{
+	m_mesh.draw();
+}
+//----------------------------------------------------------------------------------------------------------------------
+void TubeMesh::drawRanges(const std::vector<GLsizei>& _counts, const std::vector<const GLvoid*>& _offsets) const
+{
+	m_mesh.drawRanges(_counts, _offsets);
+}
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,35 @@
+#include "TurtleTable.h"
+//----------------------------------------------------------------------------------------------------------------------
+constexpr unsigned TurtleTable::s_rotationCount;
+//----------------------------------------------------------------------------------------------------------------------
+void TurtleTable::build(float _angle)
+{
+	for (unsigned i=0; i<s_rotationCount; ++i)
+	{
+		m_rotations[i] = rotation(static_cast<uint8_t>(Alphabet::ROLL_RIGHT + i), _angle);
+	}
+}
+//----------------------------------------------------------------------------------------------------------------------
+Quaternion TurtleTable::rotation(uint8_t _symbol, float _angle)
+{
+	//The heading is the local y axis, the left is -x and the up is z
+	const ngl::Vec3 heading(0.0f, 1.0f, 0.0f);
+	const ngl::Vec3 left(-1.0f, 0.0f, 0.0f);
+	const ngl::Vec3 up(0.0f, 0.0f, 1.0f);
+	switch (_symbol)
+	{
+		//Roll clockwise about the heading
+		case Alphabet::ROLL_RIGHT : return Quaternion::fromAxisAngle(heading, -_angle);
+		//Roll anticlockwise about the heading
+		case Alphabet::ROLL_LEFT : return Quaternion::fromAxisAngle(heading, _angle);
+		//Turn the heading towards the left, about the up axis
+		case Alphabet::TURN_LEFT : return Quaternion::fromAxisAngle(up, _angle);
+		//Turn the heading towards the right, about the up axis
+		case Alphabet::TURN_RIGHT : return Quaternion::fromAxisAngle(up, -_angle);
+		//Pitch the heading down, about the left axis
+		case Alphabet::PITCH_DOWN : return Quaternion::fromAxisAngle(left, _angle);
+		//Pitch the heading up, about the left axis
+		case Alphabet::PITCH_UP : return Quaternion::fromAxisAngle(left, -_angle);
+		default : return Quaternion();
+	}
+}
@@ -1,6 +1,65 @@
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QGuiApplication>
+#include "HeadlessRenderer.h"
 #include "MainWindow.h"
 
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief Read the headless options from the command line
+/// @param _arguments The command line arguments
+/// @param _options The options to fill in
+/// @return False if the arguments are invalid
+//----------------------------------------------------------------------------------------------------------------------
+bool parseHeadlessOptions(const QStringList& _arguments, HeadlessOptions& _options)
+{
+	QCommandLineParser parser;
+	parser.setApplicationDescription("PlantSim. Pass --headless to render without a window");
+	parser.addHelpOption();
+	parser.addOptions({
+		{"headless", "Render to images without a window."},
+		{"preset", "PlantBlueprint preset to grow. Can be repeated or comma separated.", "name"},
+		{"count", "Number of plants.", "n"},
+		{"spacing", "Distance between plants.", "distance"},
+		{"impostor-distance", "Distance beyond which plants are drawn as impostors.", "distance"},
+		{"depth", "Number of simulation updates.", "n"},
+		{"stream", "Derive the plants to --depth as they are created, without storing the L-system strings. Branches start from the end of the branch their bracket opens in, so shapes differ from runs without --stream."},
+		{"frames", "Number of frames to render.", "n"},
+		{"width", "Image width.", "pixels"},
+		{"height", "Image height.", "pixels"},
+		{"output", "Directory for the images and timings.csv.", "directory"},
+		{"cameras", "File of camera keys, one \"eyeX eyeY eyeZ lookX lookY lookZ\" per line.", "file"},
+		{"seed", "Random seed.", "n"},
+		{"no-images", "Only write the timings."}
+	});
+	parser.process(_arguments);
+
+	if (parser.isSet("preset"))
+	{
+		_options.m_presets.clear();
+		for (const QString& value : parser.values("preset"))
+		{
+			for (const QString& name : value.split(',', QString::SkipEmptyParts)) _options.m_presets.push_back(name.toStdString());
+		}
+	}
+
+	bool isValid = true;
+	bool ok = true;
+	if (parser.isSet("count")) {_options.m_plantCount = parser.value("count").toUInt(&ok); isValid &= ok && _options.m_plantCount > 0;}
+	if (parser.isSet("spacing")) {_options.m_spacing = parser.value("spacing").toFloat(&ok); isValid &= ok;}
+	if (parser.isSet("impostor-distance")) {_options.m_impostorDistance = parser.value("impostor-distance").toFloat(&ok); isValid &= ok && _options.m_impostorDistance > 0.0f;}
+	if (parser.isSet("depth")) {_options.m_depth = parser.value("depth").toUInt(&ok); isValid &= ok;}
+	if (parser.isSet("frames")) {_options.m_frames = parser.value("frames").toUInt(&ok); isValid &= ok;}
+	if (parser.isSet("width")) {_options.m_width = parser.value("width").toInt(&ok); isValid &= ok && _options.m_width > 0;}
+	if (parser.isSet("height")) {_options.m_height = parser.value("height").toInt(&ok); isValid &= ok && _options.m_height > 0;}
+	if (parser.isSet("seed")) {_options.m_seed = parser.value("seed").toUInt(&ok); isValid &= ok;}
+	if (parser.isSet("output")) _options.m_outputDirectory = parser.value("output").toStdString();
+	if (parser.isSet("cameras")) _options.m_cameraFile = parser.value("cameras").toStdString();
+	_options.m_writeImages = !parser.isSet("no-images");
+	_options.m_streamDerivation = parser.isSet("stream");
+
+	return isValid && !_options.m_presets.empty();
+}
+
 int main(int argc, char **argv)
 {
 	//----------------------------------------------------------------------------------------------------------------------
@@ -23,6 +82,26 @@ int main(int argc, char **argv)
 
 	QSurfaceFormat::setDefaultFormat(format);
 
+	//----------------------------------------------------------------------------------------------------------------------
+	// Render without a window if asked to
+	//----------------------------------------------------------------------------------------------------------------------
+
+	QStringList arguments;
+	for (int i=0; i<argc; ++i) arguments << QString::fromLocal8Bit(argv[i]);
+	if (arguments.contains("--headless") || arguments.contains("--help") || arguments.contains("-h"))
+	{
+		//Don't need a display unless the platform has been chosen
+		if (qgetenv("QT_QPA_PLATFORM").isEmpty()) qputenv("QT_QPA_PLATFORM", "offscreen");
+		QGuiApplication app(argc, argv);
+		HeadlessOptions options;
+		if (!parseHeadlessOptions(app.arguments(), options))
+		{
+			qCritical("Invalid command line options, see --help");
+			return 1;
+		}
+		return HeadlessRenderer(options).run();
+	}
+
 	//----------------------------------------------------------------------------------------------------------------------
 	// Create the application and window
 	//----------------------------------------------------------------------------------------------------------------------